@@ -0,0 +1,151 @@
+#pragma once
+
+#ifndef DAK_BENCHMARKS_BENCHMARK_H
+#define DAK_BENCHMARKS_BENCHMARK_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace dak::benchmarks
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Minimal portable micro-benchmark harness.
+   //
+   // Each benchmark is a function that runs the measured operation a given
+   // number of times. The harness grows the number of iterations until a run
+   // takes long enough to be timed reliably, then keeps the fastest of a few
+   // runs, which is the one least disturbed by the rest of the machine.
+
+   // Seed used to generate the inputs, so that every run measures the same work.
+   constexpr std::uint64_t fixed_seed = 0x7A271C5EEDull;
+
+   // Random generator with a fixed sequence on all platforms.
+   // The standard distributions are not portable, so indexes are taken modulo.
+   struct random_t
+   {
+      random_t(std::uint64_t a_seed = fixed_seed) : my_engine(a_seed) {}
+
+      // A number in [0, a_count).
+      size_t index(size_t a_count) { return size_t(my_engine() % a_count); }
+
+      // A number in [a_min, a_max].
+      int between(int a_min, int a_max) { return a_min + int(index(size_t(a_max - a_min + 1))); }
+
+   private:
+      std::mt19937_64 my_engine;
+   };
+
+   // Keep the compiler from optimizing away a value that is never used.
+   template <class T>
+   inline void keep(const T& a_value)
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : "r,m"(a_value) : "memory");
+#else
+      static const void* volatile sink;
+      sink = &a_value;
+#endif
+   }
+
+   // A benchmark: runs its operation the given number of times.
+   struct benchmark_t
+   {
+      std::string                            name;
+      std::function<void(std::uint64_t)>     run;
+   };
+
+   // Measure of a benchmark.
+   struct result_t
+   {
+      std::string    name;
+      std::uint64_t  iterations = 0;
+      double         ns_per_op = 0.;
+   };
+
+   // All the benchmarks to run.
+   struct suite_t
+   {
+      // Add a benchmark.
+      void add(const std::string& a_name, std::function<void(std::uint64_t)> a_run)
+      {
+         my_benchmarks.push_back(benchmark_t{ a_name, std::move(a_run) });
+      }
+
+      // The benchmarks that were added.
+      const std::vector<benchmark_t>& benchmarks() const { return my_benchmarks; }
+
+   private:
+      std::vector<benchmark_t> my_benchmarks;
+   };
+
+   // Measure a benchmark, running it for about the given time per run.
+   inline result_t measure(const benchmark_t& a_benchmark, std::chrono::milliseconds a_run_time, size_t a_runs_count = 5)
+   {
+      using clock = std::chrono::steady_clock;
+
+      const auto time_run = [&a_benchmark](std::uint64_t an_iterations) -> double
+      {
+         const auto start = clock::now();
+         a_benchmark.run(an_iterations);
+         return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+      };
+
+      // Grow the iterations until a run takes at least a tenth of the desired time.
+      const double run_ns = std::chrono::duration<double, std::nano>(a_run_time).count();
+      std::uint64_t iterations = 1;
+      double elapsed = time_run(iterations);
+      while (elapsed < run_ns / 10. && iterations < (std::uint64_t(1) << 40))
+      {
+         iterations *= 2;
+         elapsed = time_run(iterations);
+      }
+
+      // Then aim for the desired time.
+      if (elapsed > 0.)
+         iterations = std::max<std::uint64_t>(1, std::uint64_t(double(iterations) * run_ns / elapsed));
+
+      double best_ns = time_run(iterations);
+      for (size_t run = 1; run < a_runs_count; ++run)
+         best_ns = std::min(best_ns, time_run(iterations));
+
+      return result_t{ a_benchmark.name, iterations, best_ns / double(iterations) };
+   }
+
+   // Write the results as a JSON array.
+   inline void write_json(std::ostream& a_stream, const std::vector<result_t>& some_results)
+   {
+      a_stream << "[";
+      for (size_t i = 0; i < some_results.size(); ++i)
+      {
+         const result_t& result = some_results[i];
+         a_stream << (i ? ",\n" : "\n")
+                  << "  { \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+                  << ", \"ns_per_op\": " << result.ns_per_op << " }";
+      }
+      a_stream << "\n]\n";
+   }
+
+   // Write the results as CSV, with a header line.
+   inline void write_csv(std::ostream& a_stream, const std::vector<result_t>& some_results)
+   {
+      a_stream << "name,iterations,ns_per_op\n";
+      for (const result_t& result : some_results)
+         a_stream << result.name << "," << result.iterations << "," << result.ns_per_op << "\n";
+   }
+
+   // The benchmarks of each library.
+   void add_tantrix_benchmarks(suite_t& a_suite);
+   void add_six_eight_benchmarks(suite_t& a_suite);
+}
+
+#endif /* DAK_BENCHMARKS_BENCHMARK_H */
@@ -0,0 +1,64 @@
+#include "dak/benchmarks/benchmark.h"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace dak::benchmarks;
+
+int main(int arg_count, char** arg_values)
+{
+   bool as_csv = false;
+   bool only_list = false;
+   chrono::milliseconds run_time(100);
+   vector<string> filters;
+   for (int arg_index = 1; arg_index < arg_count; ++arg_index)
+   {
+      const string arg(arg_values[arg_index]);
+      if (arg == "--csv")
+         as_csv = true;
+      else if (arg == "--json")
+         as_csv = false;
+      else if (arg == "--run-time" && arg_index + 1 < arg_count)
+         run_time = chrono::milliseconds(stoul(arg_values[++arg_index]));
+      else if (arg == "--list")
+         only_list = true;
+      else
+         filters.emplace_back(arg);
+   }
+
+   suite_t suite;
+   add_tantrix_benchmarks(suite);
+   add_six_eight_benchmarks(suite);
+
+   // Only run the benchmarks whose name contains one of the filters.
+   vector<result_t> results;
+   for (const benchmark_t& benchmark : suite.benchmarks())
+   {
+      const bool is_selected = filters.empty() || any_of(filters.begin(), filters.end(), [&benchmark](const string& filter)
+      {
+         return benchmark.name.find(filter) != string::npos;
+      });
+      if (!is_selected)
+         continue;
+
+      if (only_list)
+      {
+         cout << benchmark.name << endl;
+         continue;
+      }
+
+      results.push_back(measure(benchmark, run_time));
+      cerr << benchmark.name << ": " << results.back().ns_per_op << " ns" << endl;
+   }
+
+   if (only_list)
+      return 0;
+
+   if (as_csv)
+      write_csv(cout, results);
+   else
+      write_json(cout, results);
+
+   return 0;
+}
@@ -0,0 +1,177 @@
+#include "dak/benchmarks/benchmark.h"
+
+#include "dak/six_eight/six_eight.h"
+#include "dak/six_eight/format.h"
+#include "dak/six_eight/parse.h"
+#include "dak/six_eight/stream.h"
+
+#include <memory>
+#include <sstream>
+
+
+namespace dak::benchmarks
+{
+   using namespace dak::six_eight;
+
+   namespace
+   {
+      // Number of boards, a power of two so indexes wrap cheaply.
+      constexpr size_t boards_count = 256;
+
+      // Size of the board.
+      constexpr int board_width = 6;
+      constexpr int board_height = 8;
+
+      // Number of tiles of a puzzle.
+      constexpr size_t puzzle_tiles_count = 8;
+
+      // Fill a board with the tiles of a random puzzle, each placed at
+      // the first random position and rotation where it fits.
+      solution_t make_board(random_t& a_random)
+      {
+         const auto& ids = tile_t::get_all_ids();
+
+         solution_t board;
+         for (size_t i = 0; i < puzzle_tiles_count; ++i)
+         {
+            const tile_t tile = tile_t(ids[a_random.index(ids.size())]).rotate(a_random.between(0, 3));
+            for (int attempt = 0; attempt < 32; ++attempt)
+            {
+               const position_t pos(a_random.between(0, board_width - 1), a_random.between(0, board_height - 1));
+               if (board.is_compatible(tile, pos))
+               {
+                  board.add_tile(tile, pos);
+                  break;
+               }
+            }
+         }
+
+         return board;
+      }
+
+      std::vector<solution_t> make_boards(std::uint64_t a_seed)
+      {
+         random_t random(a_seed);
+         std::vector<solution_t> boards;
+         for (size_t i = 0; i < boards_count; ++i)
+            boards.push_back(make_board(random));
+         return boards;
+      }
+
+      // A candidate part for each board: a random tile at a random position.
+      std::vector<solution_t::part_t> make_candidates(std::uint64_t a_seed)
+      {
+         const auto& ids = tile_t::get_all_ids();
+
+         random_t random(a_seed);
+         std::vector<solution_t::part_t> candidates;
+         for (size_t i = 0; i < boards_count; ++i)
+         {
+            const tile_t tile = tile_t(ids[random.index(ids.size())]).rotate(random.between(0, 3));
+            const position_t pos(random.between(0, board_width - 1), random.between(0, board_height - 1));
+            candidates.emplace_back(tile, pos);
+         }
+         return candidates;
+      }
+
+      std::string solutions_text(const std::vector<solution_t>& some_boards)
+      {
+         all_solutions_t solutions(some_boards.begin(), some_boards.end());
+         std::ostringstream stream;
+         write_solutions(stream, solutions);
+         return stream.str();
+      }
+
+      // Puzzles, one per line, each made of random tiles.
+      std::string puzzles_text(std::uint64_t a_seed)
+      {
+         const auto& ids = tile_t::get_all_ids();
+
+         random_t random(a_seed);
+         std::string text;
+         for (size_t i = 0; i < boards_count; ++i)
+         {
+            for (size_t j = 0; j < puzzle_tiles_count; ++j)
+            {
+               text += ids[random.index(ids.size())];
+               text += (j + 1 < puzzle_tiles_count) ? ' ' : '\n';
+            }
+         }
+         return text;
+      }
+   }
+
+   void add_six_eight_benchmarks(suite_t& a_suite)
+   {
+      auto boards = std::make_shared<std::vector<solution_t>>(make_boards(fixed_seed));
+      auto candidates = std::make_shared<std::vector<solution_t::part_t>>(make_candidates(fixed_seed + 1));
+
+      a_suite.add("six_eight/solution_is_occupied", [boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            const position_t pos(int(i % board_width), int((i / board_width) % board_height));
+            keep((*boards)[i % boards_count].is_occupied(pos));
+         }
+      });
+
+      a_suite.add("six_eight/solution_is_compatible", [boards, candidates](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*boards)[i % boards_count].is_compatible((*candidates)[i % boards_count]));
+      });
+
+      // Adding a tile changes the board, so each run adds to a copy.
+      // The cost of the copy alone is measured separately.
+      a_suite.add("six_eight/solution_copy", [boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            solution_t board((*boards)[i % boards_count]);
+            keep(board);
+         }
+      });
+
+      a_suite.add("six_eight/solution_copy_add_tile", [boards, candidates](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            solution_t board((*boards)[i % boards_count]);
+            board.add_part((*candidates)[i % boards_count]);
+            keep(board);
+         }
+      });
+
+      a_suite.add("six_eight/solution_next_position", [boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*boards)[i % boards_count].get_next_position_to_fill());
+      });
+
+      auto solutions = std::make_shared<std::string>(solutions_text(*boards));
+      auto puzzles = std::make_shared<std::string>(puzzles_text(fixed_seed + 2));
+
+      a_suite.add("six_eight/parse_solutions/256", [solutions](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep(parse_solutions(*solutions).size());
+      });
+
+      a_suite.add("six_eight/stream_solutions/256", [solutions](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            std::istringstream stream(*solutions);
+            all_solutions_t parsed;
+            stream >> parsed;
+            keep(parsed.size());
+         }
+      });
+
+      a_suite.add("six_eight/parse_puzzles/256", [puzzles](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep(parse_puzzles(*puzzles).size());
+      });
+   }
+}
@@ -0,0 +1,212 @@
+#include "dak/benchmarks/benchmark.h"
+
+#include "dak/tantrix/tantrix.h"
+#include "dak/tantrix/format.h"
+#include "dak/tantrix/parse.h"
+#include "dak/tantrix/stream.h"
+
+#include <memory>
+#include <numeric>
+#include <sstream>
+
+
+namespace dak::benchmarks
+{
+   using namespace dak::tantrix;
+
+   namespace
+   {
+      // Number of boards of each size, a power of two so indexes can wrap with a mask.
+      constexpr size_t boards_count = 256;
+
+      // Puzzle giving the line color used to compare solutions and find lines.
+      const any_shape_puzzle_t& board_puzzle()
+      {
+         static const any_shape_puzzle_t puzzle({ 1, 2, 3 }, { color_t::red() }, false);
+         return puzzle;
+      }
+
+      // Grow a board like the search does: each new tile is placed, in a
+      // rotation compatible with its neighbours, at a random border position.
+      solution_t make_board(random_t& a_random, size_t a_tiles_count)
+      {
+         std::vector<int> numbers(56);
+         std::iota(numbers.begin(), numbers.end(), 1);
+         for (size_t i = numbers.size() - 1; i > 0; --i)
+            std::swap(numbers[i], numbers[a_random.index(i + 1)]);
+
+         solution_t board(board_puzzle());
+         board.add_tile(tile_t(numbers[0]).rotate(a_random.between(0, 5)), position_t(0, 0));
+
+         for (size_t i = 1; i < numbers.size() && board.tiles_count() < a_tiles_count; ++i)
+         {
+            const tile_t tile(numbers[i]);
+            const solution_t::positions_t borders = board.get_borders();
+            for (int attempt = 0; attempt < 8; ++attempt)
+            {
+               const position_t pos = borders[a_random.index(borders.size())];
+               const unsigned rotations = board.compatible_rotations(tile, pos);
+               if (!rotations)
+                  continue;
+
+               int rotation = a_random.between(0, 5);
+               while ((rotations & (1u << rotation)) == 0)
+                  rotation = (rotation + 1) % 6;
+               board.add_tile(tile.rotate(rotation), pos);
+               break;
+            }
+         }
+
+         return board;
+      }
+
+      std::vector<solution_t> make_boards(std::uint64_t a_seed, size_t a_tiles_count)
+      {
+         random_t random(a_seed);
+         std::vector<solution_t> boards;
+         for (size_t i = 0; i < boards_count; ++i)
+            boards.push_back(make_board(random, a_tiles_count));
+         return boards;
+      }
+
+      // A candidate part for each board: a random tile at a random border position.
+      std::vector<solution_t::part_t> make_candidates(const std::vector<solution_t>& some_boards, std::uint64_t a_seed)
+      {
+         random_t random(a_seed);
+         std::vector<solution_t::part_t> candidates;
+         for (const solution_t& board : some_boards)
+         {
+            const solution_t::positions_t borders = board.get_borders();
+            const position_t pos = borders[random.index(borders.size())];
+            candidates.emplace_back(tile_t(random.between(1, 56)).rotate(random.between(0, 5)), pos);
+         }
+         return candidates;
+      }
+
+      std::string solutions_text(const std::vector<solution_t>& some_boards)
+      {
+         all_solutions_t solutions(some_boards.begin(), some_boards.end());
+         std::ostringstream stream;
+         write_solutions(stream, solutions);
+         return stream.str();
+      }
+   }
+
+   void add_tantrix_benchmarks(suite_t& a_suite)
+   {
+      auto small_boards = std::make_shared<std::vector<solution_t>>(make_boards(fixed_seed, 10));
+      auto large_boards = std::make_shared<std::vector<solution_t>>(make_boards(fixed_seed + 1, 20));
+      auto candidates = std::make_shared<std::vector<solution_t::part_t>>(make_candidates(*large_boards, fixed_seed + 2));
+
+      a_suite.add("tantrix/tile_color", [](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            const tile_t tile = tile_t(int(1 + i % 56)).rotate(int(i % 6));
+            keep(tile.color(direction_t(int(i % 6))));
+         }
+      });
+
+      a_suite.add("tantrix/solution_is_compatible", [large_boards, candidates](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*large_boards)[i % boards_count].is_compatible((*candidates)[i % boards_count]));
+      });
+
+      a_suite.add("tantrix/solution_compatible_rotations", [large_boards, candidates](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            const solution_t::part_t& part = (*candidates)[i % boards_count];
+            keep((*large_boards)[i % boards_count].compatible_rotations(part.tile, part.pos));
+         }
+      });
+
+      a_suite.add("tantrix/solution_get_borders/10", [small_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*small_boards)[i % boards_count].get_borders(color_t::red()).size());
+      });
+
+      a_suite.add("tantrix/solution_get_borders/20", [large_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*large_boards)[i % boards_count].get_borders(color_t::red()).size());
+      });
+
+      a_suite.add("tantrix/solution_get_holes/20", [large_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*large_boards)[i % boards_count].get_holes().size());
+      });
+
+      a_suite.add("tantrix/solution_has_line/20", [large_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*large_boards)[i % boards_count].has_line(color_t::red(), false));
+      });
+
+      a_suite.add("tantrix/solution_is_valid/20", [large_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*large_boards)[i % boards_count].is_valid());
+      });
+
+      // Normalizing changes the board, so each run normalizes a copy.
+      // The cost of the copy alone is measured separately.
+      a_suite.add("tantrix/solution_copy/20", [large_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            solution_t board((*large_boards)[i % boards_count]);
+            keep(board);
+         }
+      });
+
+      a_suite.add("tantrix/solution_copy_normalize/20", [large_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            solution_t board((*large_boards)[i % boards_count]);
+            board.normalize();
+            keep(board);
+         }
+      });
+
+      a_suite.add("tantrix/solution_compare/20", [large_boards](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep((*large_boards)[i % boards_count] <=> (*large_boards)[(i + 1) % boards_count]);
+      });
+
+      auto text = std::make_shared<std::string>(solutions_text(*large_boards));
+
+      a_suite.add("tantrix/parse_solutions/256x20", [text](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+            keep(parse_solutions(*text).size());
+      });
+
+      a_suite.add("tantrix/stream_solutions/256x20", [text](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            std::istringstream stream(*text);
+            all_solutions_t solutions;
+            stream >> solutions;
+            keep(solutions.size());
+         }
+      });
+
+      a_suite.add("tantrix/stream_puzzle", [](std::uint64_t an_iterations)
+      {
+         for (std::uint64_t i = 0; i < an_iterations; ++i)
+         {
+            std::istringstream stream("tiles: 18 22 23 26 27 33 34 35 36 47 53 55\nloops: G\nholes: 2\n");
+            std::shared_ptr<puzzle_t> puzzle;
+            stream >> puzzle;
+            keep(puzzle);
+         }
+      });
+   }
+}
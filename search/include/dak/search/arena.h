@@ -0,0 +1,145 @@
+#pragma once
+
+#ifndef DAK_SEARCH_ARENA_H
+#define DAK_SEARCH_ARENA_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Bump allocator for the temporary containers created at each search node.
+   //
+   // Memory is carved linearly out of large blocks. Deallocation does nothing:
+   // memory is only reclaimed by rewinding the arena to an earlier mark, which
+   // releases everything allocated after it at once. The blocks themselves are
+   // kept, so once the arena has grown to the depth of the search, allocating
+   // no longer calls the global allocator.
+   //
+   // An arena must only be used by one thread at a time.
+
+   struct arena_t : std::pmr::memory_resource
+   {
+      // Position in the arena, used to release all memory allocated after it.
+      struct mark_t
+      {
+         size_t block_index = 0;
+         size_t used = 0;
+      };
+
+      // Rewind the arena to where it was when the scope was created.
+      struct scope_t
+      {
+         scope_t(arena_t& an_arena) : my_arena(an_arena), my_mark(an_arena.mark()) {}
+         ~scope_t() { my_arena.rewind(my_mark); }
+
+         scope_t(const scope_t&) = delete;
+         scope_t& operator=(const scope_t&) = delete;
+
+      private:
+         arena_t& my_arena;
+         mark_t   my_mark;
+      };
+
+      // Create an arena which allocates blocks of at least the given size.
+      arena_t(size_t a_block_size = 256 * 1024)
+      : my_block_size(a_block_size)
+      {
+      }
+
+      arena_t(const arena_t&) = delete;
+      arena_t& operator=(const arena_t&) = delete;
+
+      // Current position in the arena.
+      mark_t mark() const
+      {
+         return mark_t{ my_block_index, my_used };
+      }
+
+      // Release all memory allocated since the mark was taken.
+      void rewind(const mark_t& a_mark)
+      {
+         my_block_index = a_mark.block_index;
+         my_used = a_mark.used;
+      }
+
+      // Release all memory, keeping the blocks for reuse.
+      void reset()
+      {
+         rewind(mark_t());
+      }
+
+      // Total size of the blocks owned by the arena.
+      size_t capacity() const
+      {
+         size_t total = 0;
+         for (const block_t& block : my_blocks)
+            total += block.size;
+         return total;
+      }
+
+   protected:
+      void* do_allocate(size_t a_bytes, size_t an_alignment) override
+      {
+         while (true)
+         {
+            if (my_block_index < my_blocks.size())
+            {
+               block_t& block = my_blocks[my_block_index];
+               const size_t start = (my_used + an_alignment - 1) & ~(an_alignment - 1);
+               if (start + a_bytes <= block.size)
+               {
+                  my_used = start + a_bytes;
+                  return block.memory.get() + start;
+               }
+
+               // Blocks after the current one are free, try the next one.
+               if (my_block_index + 1 < my_blocks.size())
+               {
+                  my_block_index += 1;
+                  my_used = 0;
+                  continue;
+               }
+            }
+
+            // Alignment is at most that of max_align_t for the search containers,
+            // which operator new[] of std::byte provides.
+            const size_t size = std::max(my_block_size, a_bytes + an_alignment);
+            my_blocks.emplace_back(block_t{ std::make_unique<std::byte[]>(size), size });
+            my_block_index = my_blocks.size() - 1;
+            my_used = 0;
+         }
+      }
+
+      void do_deallocate(void*, size_t, size_t) override
+      {
+      }
+
+      bool do_is_equal(const std::pmr::memory_resource& an_other) const noexcept override
+      {
+         return this == &an_other;
+      }
+
+   private:
+      struct block_t
+      {
+         std::unique_ptr<std::byte[]>  memory;
+         size_t                        size = 0;
+      };
+
+      std::vector<block_t> my_blocks;
+      size_t               my_block_size;
+      size_t               my_block_index = 0;
+      size_t               my_used = 0;
+   };
+}
+
+#endif /* DAK_SEARCH_ARENA_H */
@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef DAK_SEARCH_BEST_PARTIAL_H
+#define DAK_SEARCH_BEST_PARTIAL_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <compare>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Rank of a partial solution.
+   //
+   // Deeper partial solutions, which have more parts placed, are better.
+   // Among those of the same depth, the problem can rank them by a score,
+   // higher being better.
+
+   struct partial_rank_t
+   {
+      size_t         depth = 0;
+      std::int64_t   score = 0;
+
+      auto operator<=>(const partial_rank_t& an_other) const = default;
+   };
+
+   // Best partial solution seen by a single thread, kept without locking.
+   template <class SOLUTION>
+   struct thread_best_partial_t
+   {
+      std::optional<SOLUTION>    solution;
+      partial_rank_t             rank;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Best partial solution seen by the solver.
+   //
+   // When a search finds no solution, because the problem has none or
+   // because the search was stopped, the best partial solution tells how
+   // close it came. The solver fills it when a search_progress_t given to
+   // it has one for its type of solution. Otherwise each hook is a single
+   // test of a null pointer per node.
+   //
+   // Each thread keeps its own best and offers it once when it stops, so
+   // the threads never contend for it. It is filled even when the search
+   // is stopped by an error or by the progress.
+
+   struct best_partial_base_t
+   {
+      virtual ~best_partial_base_t() = default;
+   };
+
+   template <class SOLUTION>
+   struct best_partial_t : best_partial_base_t
+   {
+      // Keep the partial solution of a thread if it is better than the best so far.
+      void offer(const thread_best_partial_t<SOLUTION>& a_thread_best)
+      {
+         if (!a_thread_best.solution)
+            return;
+
+         std::lock_guard lock(my_lock);
+         if (my_best.solution && a_thread_best.rank <= my_best.rank)
+            return;
+
+         my_best = a_thread_best;
+      }
+
+      // The best partial solution, if any was seen. Must not be called during the search.
+      const std::optional<SOLUTION>& solution() const { return my_best.solution; }
+      const partial_rank_t& rank() const { return my_best.rank; }
+
+      // Forget the best partial solution, to reuse it for another search.
+      void clear() { my_best = thread_best_partial_t<SOLUTION>(); }
+
+   private:
+      std::mutex                       my_lock;
+      thread_best_partial_t<SOLUTION>  my_best;
+   };
+}
+
+#endif /* DAK_SEARCH_BEST_PARTIAL_H */
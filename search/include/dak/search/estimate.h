@@ -0,0 +1,138 @@
+#pragma once
+
+#ifndef DAK_SEARCH_ESTIMATE_H
+#define DAK_SEARCH_ESTIMATE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Estimated size of the search tree of a problem.
+
+   struct estimate_t
+   {
+      // Number of random probes that were averaged.
+      size_t   probes_count = 0;
+
+      // Estimated number of partial solutions the solver will visit.
+      double   nodes_count = 0.;
+
+      // Estimated single-threaded solving time, in milliseconds.
+      double   milliseconds = 0.;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Estimate the size of the search tree of a problem without solving it.
+   //
+   // Uses Knuth's random probing: follow random paths from the root to a
+   // leaf, multiplying the number of children found at each level. The
+   // average of the products over many probes is an unbiased estimate of
+   // the number of nodes of the full search tree.
+   //
+   // The time is estimated the same way, by weighting the measured time
+   // taken to expand each probed node into its children.
+   //
+   // A problem that remembers the partial solutions it visited, through a
+   // transposition table, would skip the nodes of the later probes and of the
+   // solver. When it provides without_transposition_table(), the probes are
+   // done on that copy of the problem instead.
+
+   template <class PROBLEM, class SOLUTION>
+   struct estimator_t
+   {
+      using problem_t = PROBLEM;
+      using solution_t = SOLUTION;
+      using sub_problem_t = typename PROBLEM::sub_problem_t;
+
+      static estimate_t estimate(const problem_t& a_problem, const solution_t& a_initial_solution, size_t a_probes_count = 1000, std::uint64_t a_seed = 0)
+      {
+         if constexpr (requires { { a_problem.without_transposition_table() } -> std::same_as<problem_t>; })
+            return estimate_problem(a_problem.without_transposition_table(), a_initial_solution, a_probes_count, a_seed);
+         else
+            return estimate_problem(a_problem, a_initial_solution, a_probes_count, a_seed);
+      }
+
+   private:
+      static estimate_t estimate_problem(const problem_t& a_problem, const solution_t& a_initial_solution, size_t a_probes_count, std::uint64_t a_seed)
+      {
+         using clock_t = std::chrono::steady_clock;
+
+         std::mt19937_64 random(a_seed);
+
+         double total_nodes = 0.;
+         double total_milliseconds = 0.;
+
+         const auto initial_sub_problems = a_problem.create_initial_sub_problems();
+
+         std::vector<child_t> children;
+         for (size_t probe = 0; probe < a_probes_count; ++probe)
+         {
+            children.clear();
+            for (const sub_problem_t& sub_problem : initial_sub_problems)
+               add_children(a_problem, sub_problem, a_initial_solution, children);
+
+            double weight = 1.;
+            while (children.size() > 0)
+            {
+               weight *= double(children.size());
+               total_nodes += weight;
+
+               std::uniform_int_distribution<size_t> pick(0, children.size() - 1);
+               const child_t child = children[pick(random)];
+
+               children.clear();
+               if (!a_problem.has_more_sub_problems(child.sub_problem))
+                  break;
+
+               const auto start_time = clock_t::now();
+               for (const sub_problem_t& sub_problem : a_problem.create_sub_problems(child.sub_problem, child.partial_solution))
+                  add_children(a_problem, sub_problem, child.partial_solution, children);
+               const auto elapsed = std::chrono::duration<double, std::milli>(clock_t::now() - start_time);
+               total_milliseconds += weight * elapsed.count();
+            }
+         }
+
+         estimate_t estimate;
+         estimate.probes_count = a_probes_count;
+         if (a_probes_count > 0)
+         {
+            estimate.nodes_count = total_nodes / double(a_probes_count);
+            estimate.milliseconds = total_milliseconds / double(a_probes_count);
+         }
+         return estimate;
+      }
+
+      struct child_t
+      {
+         sub_problem_t  sub_problem;
+         solution_t     partial_solution;
+      };
+
+      // Add all the compatible placements of the tile of the sub-problem.
+      static void add_children(const problem_t& a_problem, const sub_problem_t& a_sub_problem, const solution_t& a_partial_solution, std::vector<child_t>& some_children)
+      {
+         const auto parts = a_problem.get_sub_problem_potential_parts(a_sub_problem, a_partial_solution);
+         for (const auto& part : parts)
+         {
+            if (!a_partial_solution.is_compatible(part))
+               continue;
+
+            child_t child{ a_sub_problem, a_partial_solution };
+            child.partial_solution.add_part(part);
+            some_children.emplace_back(std::move(child));
+         }
+      }
+   };
+}
+
+#endif /* DAK_SEARCH_ESTIMATE_H */
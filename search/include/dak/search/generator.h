@@ -0,0 +1,164 @@
+#pragma once
+
+#ifndef DAK_SEARCH_GENERATOR_H
+#define DAK_SEARCH_GENERATOR_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Coroutine producing values one at a time, pulled with a range-for loop.
+   //
+   // The yielded value is only valid until the loop advances, which lets the
+   // coroutine reuse the same object for every value it yields.
+   //
+   // If one of the parameters of the coroutine is a memory resource, the
+   // coroutine frame is allocated from it, otherwise from the default resource.
+
+   template <class T>
+   struct generator_t
+   {
+      struct promise_type
+      {
+         generator_t get_return_object()
+         {
+            return generator_t(std::coroutine_handle<promise_type>::from_promise(*this));
+         }
+
+         std::suspend_always initial_suspend() noexcept { return {}; }
+         std::suspend_always final_suspend() noexcept { return {}; }
+
+         std::suspend_always yield_value(const T& a_value) noexcept
+         {
+            my_value = std::addressof(a_value);
+            return {};
+         }
+
+         void return_void() {}
+
+         void unhandled_exception() { my_exception = std::current_exception(); }
+
+         // Allocate the coroutine frame from the memory resource found in the parameters.
+         template <class... ARGS>
+         static void* operator new(std::size_t a_size, const ARGS&... some_args)
+         {
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+            (find_resource(some_args, resource), ...);
+            return allocate(a_size, resource);
+         }
+
+         static void operator delete(void* a_frame, std::size_t a_size)
+         {
+            std::pmr::memory_resource* resource;
+            std::memcpy(&resource, static_cast<std::byte*>(a_frame) + resource_offset(a_size), sizeof(resource));
+            resource->deallocate(a_frame, resource_offset(a_size) + sizeof(resource), alignof(std::max_align_t));
+         }
+
+         const T*             my_value = nullptr;
+         std::exception_ptr   my_exception;
+
+      private:
+         template <class ARG>
+         static void find_resource(const ARG& an_arg, std::pmr::memory_resource*& a_resource)
+         {
+            if constexpr (std::is_convertible_v<const ARG&, std::pmr::memory_resource*>)
+               if (an_arg)
+                  a_resource = an_arg;
+         }
+
+         // The memory resource is kept after the frame, to deallocate it.
+         static std::size_t resource_offset(std::size_t a_size)
+         {
+            return (a_size + alignof(std::pmr::memory_resource*) - 1) & ~(alignof(std::pmr::memory_resource*) - 1);
+         }
+
+         static void* allocate(std::size_t a_size, std::pmr::memory_resource* a_resource)
+         {
+            void* frame = a_resource->allocate(resource_offset(a_size) + sizeof(a_resource), alignof(std::max_align_t));
+            std::memcpy(static_cast<std::byte*>(frame) + resource_offset(a_size), &a_resource, sizeof(a_resource));
+            return frame;
+         }
+      };
+
+      struct sentinel_t {};
+
+      struct iterator_t
+      {
+         using iterator_category = std::input_iterator_tag;
+         using difference_type = std::ptrdiff_t;
+         using value_type = T;
+
+         const T& operator*() const { return *my_coroutine.promise().my_value; }
+         const T* operator->() const { return my_coroutine.promise().my_value; }
+
+         iterator_t& operator++()
+         {
+            my_coroutine.resume();
+            rethrow_if_failed();
+            return *this;
+         }
+
+         void operator++(int) { ++*this; }
+
+         bool operator==(sentinel_t) const { return my_coroutine.done(); }
+
+         void rethrow_if_failed() const
+         {
+            if (my_coroutine.promise().my_exception)
+               std::rethrow_exception(my_coroutine.promise().my_exception);
+         }
+
+         std::coroutine_handle<promise_type> my_coroutine;
+      };
+
+      generator_t(generator_t&& an_other) noexcept
+      : my_coroutine(std::exchange(an_other.my_coroutine, nullptr))
+      {
+      }
+
+      generator_t& operator=(generator_t&& an_other) noexcept
+      {
+         std::swap(my_coroutine, an_other.my_coroutine);
+         return *this;
+      }
+
+      ~generator_t()
+      {
+         if (my_coroutine)
+            my_coroutine.destroy();
+      }
+
+      // Start producing values. Can only be called once.
+      iterator_t begin()
+      {
+         iterator_t iter{ my_coroutine };
+         ++iter;
+         return iter;
+      }
+
+      sentinel_t end() const { return {}; }
+
+   private:
+      explicit generator_t(std::coroutine_handle<promise_type> a_coroutine)
+      : my_coroutine(a_coroutine)
+      {
+      }
+
+      std::coroutine_handle<promise_type> my_coroutine;
+   };
+}
+
+#endif /* DAK_SEARCH_GENERATOR_H */
@@ -0,0 +1,99 @@
+#pragma once
+
+#ifndef DAK_SEARCH_INSTRUMENTATION_H
+#define DAK_SEARCH_INSTRUMENTATION_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Optional counts of the candidates rejected by each search rule.
+   //
+   // Only compiled in when DAK_SEARCH_INSTRUMENTATION is defined, which the
+   // DAK_SEARCH_INSTRUMENTATION CMake option does. Otherwise the counting
+   // macro expands to nothing and the search is unchanged.
+   //
+   // The problems count their rejections from their const strategies, which
+   // do not know which solver thread runs them, so each thread counts in its
+   // own thread-local counts. The solver clears them when a thread starts
+   // searching and adds them to the progress counters when it is done.
+   //
+   // Rejections are counted by the depth of the node that would have been
+   // created, which is the number of parts already in the partial solution.
+
+   struct rule_counts_t
+   {
+      // The rules of the solver and of the tantrix puzzles.
+      enum rule_t
+      {
+         incompatible_part,      // Part rejected by is_compatible().
+         invalid_solution,       // Complete solution rejected by is_solution_valid().
+         incompatible_rotation,  // Tile rotation filtered out by compatible_rotations().
+         border_bound,           // Any-shape sub-puzzle cut by the border ends bound.
+         adjacent_color,         // Triangle tile skipped for lacking the adjacent color.
+         line_bound,             // Fixed shape partial solution whose lines cannot be completed.
+         rules_count
+      };
+
+      // Same maximum depth as the depth histogram of the progress counters.
+      static constexpr size_t max_depth = 48;
+
+      static const char* rule_name(rule_t a_rule)
+      {
+         static const char* const names[rules_count] =
+         {
+            "incompatible_part",
+            "invalid_solution",
+            "incompatible_rotation",
+            "border_bound",
+            "adjacent_color",
+            "line_bound",
+         };
+         return names[a_rule];
+      }
+
+      void add(rule_t a_rule, size_t a_depth, std::uint64_t a_count = 1)
+      {
+         counts[a_rule][a_depth < max_depth ? a_depth : max_depth - 1] += a_count;
+      }
+
+      void add(const rule_counts_t& some_other_counts)
+      {
+         for (size_t rule = 0; rule < rules_count; ++rule)
+            for (size_t depth = 0; depth < max_depth; ++depth)
+               counts[rule][depth] += some_other_counts.counts[rule][depth];
+      }
+
+      std::uint64_t total(rule_t a_rule) const
+      {
+         std::uint64_t total = 0;
+         for (const std::uint64_t count : counts[a_rule])
+            total += count;
+         return total;
+      }
+
+      // The counts of the calling thread.
+      static rule_counts_t& thread_counts()
+      {
+         static thread_local rule_counts_t counts;
+         return counts;
+      }
+
+      std::uint64_t counts[rules_count][max_depth] = {};
+   };
+}
+
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+#define DAK_SEARCH_COUNT_REJECTED(a_rule, a_depth, a_count) \
+   ::dak::search::rule_counts_t::thread_counts().add(::dak::search::rule_counts_t::a_rule, (a_depth), (a_count))
+#else
+#define DAK_SEARCH_COUNT_REJECTED(a_rule, a_depth, a_count) ((void)0)
+#endif
+
+#endif /* DAK_SEARCH_INSTRUMENTATION_H */
@@ -0,0 +1,300 @@
+#pragma once
+
+#ifndef DAK_SEARCH_PROGRESS_H
+#define DAK_SEARCH_PROGRESS_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/search/best_partial.h"
+#include "dak/search/instrumentation.h"
+#include "dak/search/trace.h"
+#include "dak/utility/progress.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Search statistics counted separately by each solver thread.
+   //
+   // Each thread counts in plain local counts_t and regularly publishes them
+   // to its own slot. Slots are aligned on their own cache lines and have a
+   // single writer, so publishing is a few relaxed stores with no contention.
+   // The readers add up all the slots when they want a total, which is rare
+   // compared to the rate at which nodes are counted.
+
+   struct progress_counters_t
+   {
+      // Maximum number of threads that have their own slot.
+      static constexpr size_t max_threads_count = 64;
+
+      // Maximum depth tracked by the depth histogram. Deeper nodes are
+      // counted in the last entry.
+      static constexpr size_t max_depth = 48;
+
+      // Counts kept locally by a thread until they are published.
+      struct counts_t
+      {
+         void add_node(size_t a_depth)
+         {
+            nodes_count += 1;
+            depths[a_depth < max_depth ? a_depth : max_depth - 1] += 1;
+         }
+
+         void add_prune()
+         {
+            prunes_count += 1;
+         }
+
+         std::uint64_t nodes_count = 0;
+         std::uint64_t prunes_count = 0;
+         std::uint64_t depths[max_depth] = {};
+      };
+
+      // Published counters of a single thread. Only that thread may publish to it.
+      struct alignas(64) thread_counters_t
+      {
+         // Add the local counts to the published counters and clear them.
+         void publish(counts_t& some_counts)
+         {
+            add(my_nodes_count, some_counts.nodes_count);
+            add(my_prunes_count, some_counts.prunes_count);
+            for (size_t depth = 0; depth < max_depth; ++depth)
+               add(my_depths[depth], some_counts.depths[depth]);
+            some_counts = counts_t();
+         }
+
+      private:
+         static void add(std::atomic<std::uint64_t>& a_counter, std::uint64_t a_count)
+         {
+            if (a_count)
+               a_counter.store(a_counter.load(std::memory_order_relaxed) + a_count, std::memory_order_relaxed);
+         }
+
+         std::atomic<std::uint64_t> my_nodes_count = 0;
+         std::atomic<std::uint64_t> my_prunes_count = 0;
+         std::atomic<std::uint64_t> my_depths[max_depth] = {};
+
+         friend struct progress_counters_t;
+      };
+
+      progress_counters_t()
+      {
+         start_counting();
+      }
+
+      // Reset all counters and restart the clock used to compute the speed.
+      // Must not be called while threads are counting.
+      void start_counting()
+      {
+         for (thread_counters_t& slot : my_slots)
+         {
+            slot.my_nodes_count = 0;
+            slot.my_prunes_count = 0;
+            for (auto& depth : slot.my_depths)
+               depth = 0;
+         }
+         my_start_time = clock_t::now().time_since_epoch().count();
+         my_stop_time = 0;
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+         my_rule_counts = rule_counts_t();
+#endif
+      }
+
+      // Stop the clock used to compute the speed.
+      void stop_counting()
+      {
+         my_stop_time = clock_t::now().time_since_epoch().count();
+      }
+
+      // Counters of the given thread.
+      thread_counters_t& thread_counters(size_t a_thread_index)
+      {
+         return my_slots[a_thread_index % max_threads_count];
+      }
+
+      // Total number of nodes counted by all threads.
+      std::uint64_t nodes_count() const
+      {
+         std::uint64_t total = 0;
+         for (const thread_counters_t& slot : my_slots)
+            total += slot.my_nodes_count.load(std::memory_order_relaxed);
+         return total;
+      }
+
+      // Total number of nodes rejected by all threads.
+      std::uint64_t prunes_count() const
+      {
+         std::uint64_t total = 0;
+         for (const thread_counters_t& slot : my_slots)
+            total += slot.my_prunes_count.load(std::memory_order_relaxed);
+         return total;
+      }
+
+      // Number of nodes counted at each depth, up to the deepest non-empty depth.
+      std::vector<std::uint64_t> depth_histogram() const
+      {
+         std::vector<std::uint64_t> histogram(max_depth, 0);
+         for (const thread_counters_t& slot : my_slots)
+            for (size_t depth = 0; depth < max_depth; ++depth)
+               histogram[depth] += slot.my_depths[depth].load(std::memory_order_relaxed);
+
+         while (histogram.size() > 0 && histogram.back() == 0)
+            histogram.pop_back();
+         return histogram;
+      }
+
+      // Number of nodes counted per second while counting.
+      double nodes_per_second() const
+      {
+         const clock_t::rep stop_time = my_stop_time.load();
+         const auto end = stop_time ? clock_t::time_point(clock_t::duration(stop_time)) : clock_t::now();
+         const auto elapsed = end - clock_t::time_point(clock_t::duration(my_start_time.load()));
+         const double seconds = std::chrono::duration<double>(elapsed).count();
+         return seconds > 0. ? double(nodes_count()) / seconds : 0.;
+      }
+
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+      // Add the rejections counted by a thread, once it is done searching.
+      void add_rule_counts(const rule_counts_t& some_counts)
+      {
+         std::lock_guard lock(my_rule_counts_lock);
+         my_rule_counts.add(some_counts);
+      }
+
+      // The rejections counted by all threads that are done searching.
+      rule_counts_t rule_counts() const
+      {
+         std::lock_guard lock(my_rule_counts_lock);
+         return my_rule_counts;
+      }
+#endif
+
+   private:
+      using clock_t = std::chrono::steady_clock;
+
+      thread_counters_t                   my_slots[max_threads_count];
+      std::atomic<clock_t::rep>           my_start_time = 0;
+      std::atomic<clock_t::rep>           my_stop_time = 0;
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+      mutable std::mutex                  my_rule_counts_lock;
+      rule_counts_t                       my_rule_counts;
+#endif
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Write the search statistics as a JSON object: the nodes, their speed,
+   // the nodes per depth and, when the search is instrumented, the candidates
+   // rejected by each rule, in total and per depth.
+
+   inline void write_json(std::ostream& a_stream, const progress_counters_t& some_counters)
+   {
+      const auto write_array = [&a_stream](const std::uint64_t* some_values, size_t a_count)
+      {
+         while (a_count > 0 && some_values[a_count - 1] == 0)
+            --a_count;
+         a_stream << "[";
+         for (size_t i = 0; i < a_count; ++i)
+            a_stream << (i ? ", " : "") << some_values[i];
+         a_stream << "]";
+      };
+
+      const std::vector<std::uint64_t> depths = some_counters.depth_histogram();
+
+      a_stream << "{\n";
+      a_stream << "  \"nodes\": " << some_counters.nodes_count() << ",\n";
+      a_stream << "  \"prunes\": " << some_counters.prunes_count() << ",\n";
+      a_stream << "  \"nodes_per_second\": " << std::uint64_t(some_counters.nodes_per_second()) << ",\n";
+      a_stream << "  \"nodes_per_depth\": ";
+      write_array(depths.data(), depths.size());
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+      const rule_counts_t rule_counts = some_counters.rule_counts();
+      a_stream << ",\n  \"rejected\": {";
+      for (size_t rule = 0; rule < rule_counts_t::rules_count; ++rule)
+      {
+         const auto rule_id = rule_counts_t::rule_t(rule);
+         a_stream << (rule ? "," : "") << "\n    \"" << rule_counts_t::rule_name(rule_id) << "\": { \"total\": " << rule_counts.total(rule_id) << ", \"per_depth\": ";
+         write_array(rule_counts.counts[rule], rule_counts_t::max_depth);
+         a_stream << " }";
+      }
+      a_stream << "\n  }";
+#endif
+      a_stream << "\n}";
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Progress that gives access to the search statistics.
+   //
+   // When the solver is given this kind of progress, its threads count
+   // directly into these counters. The total passed to update_progress()
+   // is the sum of all thread counters at the time it is reported.
+   //
+   // When given a trace recorder, the solver also records its timeline.
+   //
+   // When given a limit on the number of solutions, the solver stops once
+   // it has found that many distinct solutions. For example, a limit of two
+   // is enough to know if a problem has a unique solution.
+   //
+   // When given a best partial solution of the type of solution searched,
+   // the solver keeps in it the best partial solution it has seen.
+
+   struct search_progress_t : utility::progress_t
+   {
+      search_progress_t(size_t a_report_every = 100000)
+      : progress_t(a_report_every)
+      {
+      }
+
+      progress_counters_t& counters() { return my_counters; }
+      const progress_counters_t& counters() const { return my_counters; }
+
+      // Trace recorder filled by the solver, if any. It must outlive the search.
+      trace_recorder_t* trace() const { return my_trace; }
+      void set_trace(trace_recorder_t* a_trace) { my_trace = a_trace; }
+
+      // Number of distinct solutions after which the solver stops, zero for no limit.
+      size_t solutions_limit() const { return my_solutions_limit; }
+      void set_solutions_limit(size_t a_limit) { my_solutions_limit = a_limit; }
+
+      // Best partial solution filled by the solver, if any. It must outlive the search.
+      best_partial_base_t* best_partial() const { return my_best_partial; }
+      void set_best_partial(best_partial_base_t* a_best_partial) { my_best_partial = a_best_partial; }
+
+   private:
+      progress_counters_t  my_counters;
+      trace_recorder_t*    my_trace = nullptr;
+      size_t               my_solutions_limit = 0;
+      best_partial_base_t* my_best_partial = nullptr;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Search progress that prints the number of nodes to a stream.
+
+   struct stream_search_progress_t : search_progress_t
+   {
+      stream_search_progress_t(std::ostream& a_stream, size_t a_report_every = 100000)
+      : search_progress_t(a_report_every), my_stream(a_stream)
+      {
+      }
+
+      void update_progress(size_t a_total_count_so_far) override
+      {
+         my_stream << "\r" << a_total_count_so_far << " nodes (" << std::uint64_t(counters().nodes_per_second()) << " nodes/s)" << std::flush;
+      }
+
+   private:
+      std::ostream& my_stream;
+   };
+}
+
+#endif /* DAK_SEARCH_PROGRESS_H */
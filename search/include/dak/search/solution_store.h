@@ -0,0 +1,135 @@
+#pragma once
+
+#ifndef DAK_SEARCH_SOLUTION_STORE_H
+#define DAK_SEARCH_SOLUTION_STORE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Store of the solutions found concurrently by the solver threads.
+   //
+   // Solutions are spread over shards using their hash, so threads only
+   // contend when they find solutions falling in the same shard. Each shard
+   // is protected by its own spin-lock, which makes merging a similar
+   // solution atomic within the shard.
+   //
+   // The SOLUTION type must provide:
+   //    - hash(): a hash that is equal for solutions that compare equal.
+   //    - operator==: to detect similar solutions.
+   //    - add_similar_solution(): to merge a similar solution.
+   //    - operator<: to produce the final sorted set of solutions.
+
+   template <class SOLUTION>
+   struct solution_store_t
+   {
+      using solution_t = SOLUTION;
+      using all_solutions_t = std::set<SOLUTION>;
+
+      // Create a store with the given number of shards.
+      solution_store_t(size_t a_shards_count = 64)
+      : my_shards(new shard_t[std::max<size_t>(a_shards_count, 1)])
+      , my_shards_count(std::max<size_t>(a_shards_count, 1))
+      {
+      }
+
+      // Add a solution or merge it with an equal solution already in the store.
+      // Return true if the solution was new. If given, the flag is set when
+      // another thread was holding the shard, for tracing the contention.
+      bool insert(solution_t&& a_solution, bool* a_was_contended = nullptr)
+      {
+         const std::uint64_t hash = a_solution.hash();
+         shard_t& shard = my_shards[hash % my_shards_count];
+
+         lock_t lock(shard.my_lock, a_was_contended);
+
+         auto& candidates = shard.my_solutions[hash];
+         for (solution_t& known : candidates)
+         {
+            if (known == a_solution)
+            {
+               known.add_similar_solution(a_solution);
+               return false;
+            }
+         }
+
+         candidates.emplace_back(std::move(a_solution));
+         my_count.fetch_add(1, std::memory_order_relaxed);
+         return true;
+      }
+
+      // Number of distinct solutions in the store.
+      size_t size() const { return my_count.load(std::memory_order_relaxed); }
+
+      // Move all the solutions out of the store, in one sorted pass.
+      all_solutions_t extract_solutions()
+      {
+         std::vector<solution_t> solutions;
+         solutions.reserve(size());
+         for (size_t i = 0; i < my_shards_count; ++i)
+         {
+            for (auto& [hash, candidates] : my_shards[i].my_solutions)
+               for (solution_t& solution : candidates)
+                  solutions.emplace_back(std::move(solution));
+            my_shards[i].my_solutions.clear();
+         }
+         my_count = 0;
+
+         std::sort(solutions.begin(), solutions.end());
+
+         all_solutions_t sorted;
+         for (solution_t& solution : solutions)
+            sorted.emplace_hint(sorted.end(), std::move(solution));
+         return sorted;
+      }
+
+   private:
+      struct lock_t
+      {
+         lock_t(std::atomic_flag& a_flag, bool* a_was_contended) : my_flag(a_flag)
+         {
+            if (!my_flag.test_and_set(std::memory_order_acquire))
+               return;
+
+            if (a_was_contended)
+               *a_was_contended = true;
+
+            do
+               my_flag.wait(true, std::memory_order_relaxed);
+            while (my_flag.test_and_set(std::memory_order_acquire));
+         }
+
+         ~lock_t()
+         {
+            my_flag.clear(std::memory_order_release);
+            my_flag.notify_one();
+         }
+
+         std::atomic_flag& my_flag;
+      };
+
+      // Shards are aligned on cache lines to avoid false sharing of the locks.
+      struct alignas(64) shard_t
+      {
+         std::atomic_flag                                                  my_lock;
+         std::unordered_map<std::uint64_t, std::vector<solution_t>>        my_solutions;
+      };
+
+      std::unique_ptr<shard_t[]>  my_shards;
+      size_t                      my_shards_count;
+      std::atomic<size_t>         my_count = 0;
+   };
+}
+
+#endif /* DAK_SEARCH_SOLUTION_STORE_H */
@@ -0,0 +1,535 @@
+#pragma once
+
+#ifndef DAK_SEARCH_SOLVE_H
+#define DAK_SEARCH_SOLVE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/search/arena.h"
+#include "dak/search/best_partial.h"
+#include "dak/search/instrumentation.h"
+#include "dak/search/progress.h"
+#include "dak/search/solution_store.h"
+#include "dak/search/thread_pool.h"
+#include "dak/search/trace.h"
+#include "dak/utility/progress.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Multi-threaded solver of problems.
+   //
+   // Drives the same problem interface as the dak solver:
+   //    - create_initial_sub_problems()
+   //    - create_sub_problems()
+   //    - get_sub_problem_potential_parts()
+   //    - has_more_sub_problems()
+   //    - is_solution_valid()
+   //
+   // When the problem provides generate_sub_problems() and
+   // generate_sub_problem_potential_parts(), they are used instead to
+   // produce the sub-problems and parts lazily. When the problem declares
+   // parts_are_compatible, its parts already fit the partial solution and
+   // the solver does not check them again.
+   //
+   // The top of the search tree is expanded breadth-first until there is
+   // enough independent work for all threads of the thread pool. Each thread
+   // then takes work items one at a time and searches them depth-first.
+   // Solutions go into a sharded solution store, so threads never wait on a
+   // global lock. Callers solving many problems should keep a thread pool
+   // and pass it to each solve, so the threads are reused.
+   //
+   // Each thread counts the nodes it visits and publishes them regularly
+   // to its own slot of the progress counters.
+   // If the given progress is a search_progress_t, its counters are used,
+   // otherwise private counters are used. The total is only added up when
+   // reporting to the progress, by one thread at a time: the others do not
+   // wait and keep searching.
+   //
+   // When compiled with DAK_SEARCH_INSTRUMENTATION, the candidates rejected
+   // by the solver and by the problem are also counted by rule and by depth.
+   //
+   // When the search progress has a trace recorder, the solver records the
+   // split of the work, each work item a thread takes from the shared list,
+   // the subtree it searches and each solution insertion, noting if the
+   // shard of the solution store was held by another thread.
+   //
+   // When the search progress has a limit on the number of solutions, the
+   // threads stop once the store has that many solutions. The solutions
+   // found are returned, which can be a few more than the limit.
+   //
+   // When the search progress has a best partial solution, each thread keeps
+   // the deepest partial solution it visits that still satisfies the rules
+   // of the problem: a complete solution rejected by is_solution_valid() is
+   // not kept. Among those of the same depth, a problem providing
+   // partial_solution_score() keeps the highest scoring.
+   // If it also provides max_partial_solution_score(), the partial solutions
+   // are no longer scored once the best of their depth has that score.
+   // The thread bests are reduced into the best partial solution once each
+   // thread stops, even when the search was stopped by the progress.
+
+   template <class PROBLEM, class SOLUTION>
+   struct solver_t
+   {
+      using problem_t = PROBLEM;
+      using solution_t = SOLUTION;
+      using sub_problem_t = typename PROBLEM::sub_problem_t;
+      using all_solutions_t = std::set<SOLUTION>;
+
+      // Solve the problem using a temporary pool of threads.
+      static all_solutions_t solve(const problem_t& a_problem, const solution_t& a_initial_solution, utility::progress_t& a_progress)
+      {
+         thread_pool_t thread_pool;
+         return solve(a_problem, a_initial_solution, a_progress, thread_pool);
+      }
+
+      // Solve the problem using the threads of the given pool.
+      static all_solutions_t solve(const problem_t& a_problem, const solution_t& a_initial_solution, utility::progress_t& a_progress, thread_pool_t& a_thread_pool)
+      {
+         solver_t solver(a_problem, a_progress);
+         solver.prepare(a_initial_solution, a_thread_pool.threads_count());
+         a_thread_pool.run([&solver, &a_thread_pool](size_t a_thread_index) { solver.search(a_thread_index, a_thread_pool.arena(a_thread_index)); });
+         return solver.finish();
+      }
+
+      // Start solving the problem in the threads of the given pool and return immediately.
+      // The problem and progress must remain valid until the solutions are available.
+      static std::future<all_solutions_t> solve_async(const problem_t& a_problem, const solution_t& a_initial_solution, utility::progress_t& a_progress, thread_pool_t& a_thread_pool)
+      {
+         auto solver = std::shared_ptr<solver_t>(new solver_t(a_problem, a_progress));
+         std::future<all_solutions_t> solutions = solver->my_async_solutions.get_future();
+
+         try
+         {
+            solver->prepare(a_initial_solution, a_thread_pool.threads_count());
+         }
+         catch (...)
+         {
+            solver->my_async_solutions.set_exception(std::current_exception());
+            return solutions;
+         }
+
+         a_thread_pool.start(
+            [solver, &a_thread_pool](size_t a_thread_index) { solver->search(a_thread_index, a_thread_pool.arena(a_thread_index)); },
+            [solver]()
+            {
+               try
+               {
+                  solver->my_async_solutions.set_value(solver->finish());
+               }
+               catch (...)
+               {
+                  solver->my_async_solutions.set_exception(std::current_exception());
+               }
+            });
+
+         return solutions;
+      }
+
+   private:
+      // A sub-problem to be solved from the given partial solution.
+      struct work_t
+      {
+         sub_problem_t  sub_problem;
+         solution_t     partial_solution;
+      };
+
+      // State of a thread searching the sub-problems.
+      struct worker_t
+      {
+         progress_counters_t::thread_counters_t&   published_counters;
+         arena_t&                                  arena;
+         size_t                                    thread_index;
+         progress_counters_t::counts_t             counts;
+         thread_best_partial_t<solution_t>         best_partial;
+      };
+
+      // Number of nodes visited by a thread before reporting progress.
+      static constexpr size_t progress_interval = 1000;
+
+      // Number of work items per thread to create before searching depth-first.
+      static constexpr size_t work_per_thread = 16;
+
+      solver_t(const problem_t& a_problem, utility::progress_t& a_progress)
+      : my_problem(a_problem), my_progress(a_progress), my_counters(select_counters(a_progress, my_own_counters))
+      , my_trace(select_trace(a_progress)), my_solutions_limit(select_solutions_limit(a_progress))
+      , my_best_partial(select_best_partial(a_progress)), my_max_partial_score(select_max_partial_score(a_problem))
+      {
+      }
+
+      static progress_counters_t& select_counters(utility::progress_t& a_progress, std::unique_ptr<progress_counters_t>& some_own_counters)
+      {
+         if (auto search_progress = dynamic_cast<search_progress_t*>(&a_progress))
+            return search_progress->counters();
+
+         some_own_counters = std::make_unique<progress_counters_t>();
+         return *some_own_counters;
+      }
+
+      static trace_recorder_t* select_trace(utility::progress_t& a_progress)
+      {
+         if (auto search_progress = dynamic_cast<search_progress_t*>(&a_progress))
+            return search_progress->trace();
+
+         return nullptr;
+      }
+
+      static size_t select_solutions_limit(utility::progress_t& a_progress)
+      {
+         if (auto search_progress = dynamic_cast<search_progress_t*>(&a_progress))
+            return search_progress->solutions_limit();
+
+         return 0;
+      }
+
+      static best_partial_t<solution_t>* select_best_partial(utility::progress_t& a_progress)
+      {
+         if (auto search_progress = dynamic_cast<search_progress_t*>(&a_progress))
+            return dynamic_cast<best_partial_t<solution_t>*>(search_progress->best_partial());
+
+         return nullptr;
+      }
+
+      static std::int64_t select_max_partial_score(const problem_t& a_problem)
+      {
+         if constexpr (requires { a_problem.max_partial_solution_score(); })
+            return a_problem.max_partial_solution_score();
+         else
+            return 0;
+      }
+
+      // Create the work items to be shared by the threads.
+      void prepare(const solution_t& a_initial_solution, size_t a_threads_count)
+      {
+         my_counters.start_counting();
+
+         if (my_trace)
+            my_trace->prepare(a_threads_count);
+         const std::int64_t split_start_ns = my_trace ? my_trace->now() : 0;
+
+         start_counting_rejections();
+         progress_counters_t::counts_t split_counts;
+         thread_best_partial_t<solution_t> split_best_partial;
+         my_work = split_work(a_initial_solution, a_threads_count * work_per_thread, split_counts, split_best_partial, my_work_depth);
+         my_counters.thread_counters(0).publish(split_counts);
+         if (my_best_partial)
+            my_best_partial->offer(split_best_partial);
+         publish_rejections();
+
+         if (my_trace)
+            my_trace->record(trace_recorder_t::caller_thread, "split", split_start_ns, "work_items", my_work.size());
+      }
+
+      // Search the work items, called by each thread of the pool.
+      void search(size_t a_thread_index, arena_t& an_arena)
+      {
+         worker_t state{ my_counters.thread_counters(a_thread_index), an_arena, a_thread_index };
+         try
+         {
+            start_counting_rejections();
+            an_arena.reset();
+            while (!my_stop_requested.load(std::memory_order_relaxed))
+            {
+               const size_t index = my_next_work.fetch_add(1);
+               if (index >= my_work.size())
+                  break;
+
+               if (my_trace)
+                  my_trace->record_instant(a_thread_index, "take_work", "work_item", index);
+               const std::int64_t subtree_start_ns = my_trace ? my_trace->now() : 0;
+
+               solve_sub_problem(my_work[index].sub_problem, my_work[index].partial_solution, my_work_depth, state);
+
+               if (my_trace)
+                  my_trace->record(a_thread_index, "subtree", subtree_start_ns, "work_item", index);
+            }
+            state.published_counters.publish(state.counts);
+            publish_rejections();
+         }
+         catch (...)
+         {
+            stop_with_error(std::current_exception());
+         }
+
+         if (my_best_partial)
+            my_best_partial->offer(state.best_partial);
+      }
+
+      // Report the final progress and gather the solutions once all threads are done.
+      all_solutions_t finish()
+      {
+         my_counters.stop_counting();
+
+         if (my_error)
+            std::rethrow_exception(my_error);
+
+         {
+            std::lock_guard lock(my_progress_lock);
+            report_total_progress();
+            my_progress.flush_progress();
+         }
+
+         return my_solutions.extract_solutions();
+      }
+
+      // Expand the search tree breadth-first until there are enough work items.
+      std::vector<work_t> split_work(const solution_t& a_initial_solution, size_t a_desired_count, progress_counters_t::counts_t& some_counts,
+                                     thread_best_partial_t<solution_t>& a_best_partial, size_t& a_depth)
+      {
+         std::vector<work_t> work;
+         for (auto& sub_problem : my_problem.create_initial_sub_problems())
+            work.emplace_back(work_t{ std::move(sub_problem), a_initial_solution });
+
+         while (work.size() > 0 && work.size() < a_desired_count && !my_stop_requested.load(std::memory_order_relaxed))
+         {
+            std::vector<work_t> next_work;
+            for (const work_t& item : work)
+            {
+               for (const auto& part : my_problem.get_sub_problem_potential_parts(item.sub_problem, item.partial_solution))
+               {
+                  if (!is_part_compatible(item.partial_solution, part))
+                  {
+                     some_counts.add_prune();
+                     DAK_SEARCH_COUNT_REJECTED(incompatible_part, a_depth, 1);
+                     continue;
+                  }
+
+                  solution_t partial_solution(item.partial_solution);
+                  partial_solution.add_part(part);
+                  some_counts.add_node(a_depth);
+
+                  if (!my_problem.has_more_sub_problems(item.sub_problem))
+                  {
+                     add_solution_if_valid(std::move(partial_solution), a_depth, trace_recorder_t::caller_thread, a_best_partial);
+                     continue;
+                  }
+
+                  if (my_best_partial)
+                     keep_if_best_partial(partial_solution, a_depth, a_best_partial);
+
+                  for (auto& sub_problem : my_problem.create_sub_problems(item.sub_problem, partial_solution))
+                     next_work.emplace_back(work_t{ std::move(sub_problem), partial_solution });
+               }
+            }
+            work.swap(next_work);
+            a_depth += 1;
+         }
+
+         return work;
+      }
+
+      // Search depth-first all the solutions of the given sub-problem.
+      //
+      // The temporary containers are allocated in the arena of the thread and
+      // released when their subtree is done, so the search does not call the
+      // global allocator once the arena has grown to the depth of the search.
+      void solve_sub_problem(const sub_problem_t& a_sub_problem, const solution_t& a_partial_solution, size_t a_depth, worker_t& a_worker)
+      {
+         arena_t::scope_t parts_scope(a_worker.arena);
+         for (const auto& part : get_potential_parts(a_sub_problem, a_partial_solution, a_worker.arena))
+         {
+            if (my_stop_requested.load(std::memory_order_relaxed))
+               return;
+
+            if (!is_part_compatible(a_partial_solution, part))
+            {
+               a_worker.counts.add_prune();
+               DAK_SEARCH_COUNT_REJECTED(incompatible_part, a_depth, 1);
+               continue;
+            }
+
+            solution_t partial_solution(a_partial_solution);
+            partial_solution.add_part(part);
+
+            a_worker.counts.add_node(a_depth);
+            if (a_worker.counts.nodes_count >= progress_interval)
+               report_progress(a_worker);
+
+            if (!my_problem.has_more_sub_problems(a_sub_problem))
+            {
+               add_solution_if_valid(std::move(partial_solution), a_depth, a_worker.thread_index, a_worker.best_partial);
+               continue;
+            }
+
+            if (my_best_partial)
+               keep_if_best_partial(partial_solution, a_depth, a_worker.best_partial);
+
+            arena_t::scope_t sub_problems_scope(a_worker.arena);
+            for (const auto& sub_problem : create_sub_problems(a_sub_problem, partial_solution, a_worker.arena))
+               solve_sub_problem(sub_problem, partial_solution, a_depth + 1, a_worker);
+         }
+      }
+
+      // Keep the partial solution if it is better than the best of the thread.
+      // Only partial solutions as deep as the best are scored. Complete
+      // solutions are only given once they are known to be valid.
+      void keep_if_best_partial(const solution_t& a_partial_solution, size_t a_depth, thread_best_partial_t<solution_t>& a_best_partial) const
+      {
+         if (a_best_partial.solution && a_depth < a_best_partial.rank.depth)
+            return;
+
+         partial_rank_t rank{ a_depth, 0 };
+         if constexpr (requires { my_problem.partial_solution_score(a_partial_solution); })
+         {
+            if constexpr (requires { my_problem.max_partial_solution_score(); })
+               if (a_best_partial.solution && a_depth == a_best_partial.rank.depth && a_best_partial.rank.score >= my_max_partial_score)
+                  return;
+
+            rank.score = my_problem.partial_solution_score(a_partial_solution);
+         }
+
+         if (a_best_partial.solution && rank <= a_best_partial.rank)
+            return;
+
+         a_best_partial.solution = a_partial_solution;
+         a_best_partial.rank = rank;
+      }
+
+      // Check that a part fits the partial solution, unless the problem guarantees it.
+      template <class PART>
+      static bool is_part_compatible(const solution_t& a_partial_solution, const PART& a_part)
+      {
+         if constexpr (requires { requires problem_t::parts_are_compatible; })
+            return true;
+         else
+            return a_partial_solution.is_compatible(a_part);
+      }
+
+      // Get the potential parts, lazily or allocated in the arena if the problem supports it.
+      auto get_potential_parts(const sub_problem_t& a_sub_problem, const solution_t& a_partial_solution, arena_t& an_arena) const
+      {
+         if constexpr (requires { my_problem.generate_sub_problem_potential_parts(a_sub_problem, a_partial_solution, &an_arena); })
+            return my_problem.generate_sub_problem_potential_parts(a_sub_problem, a_partial_solution, &an_arena);
+         else if constexpr (requires { my_problem.get_sub_problem_potential_parts(a_sub_problem, a_partial_solution, &an_arena); })
+            return my_problem.get_sub_problem_potential_parts(a_sub_problem, a_partial_solution, &an_arena);
+         else
+            return my_problem.get_sub_problem_potential_parts(a_sub_problem, a_partial_solution);
+      }
+
+      // Create the sub-problems, lazily or allocated in the arena if the problem supports it.
+      auto create_sub_problems(const sub_problem_t& a_sub_problem, const solution_t& a_partial_solution, arena_t& an_arena) const
+      {
+         if constexpr (requires { my_problem.generate_sub_problems(a_sub_problem, a_partial_solution, &an_arena); })
+            return my_problem.generate_sub_problems(a_sub_problem, a_partial_solution, &an_arena);
+         else if constexpr (requires { my_problem.create_sub_problems(a_sub_problem, a_partial_solution, &an_arena); })
+            return my_problem.create_sub_problems(a_sub_problem, a_partial_solution, &an_arena);
+         else
+            return my_problem.create_sub_problems(a_sub_problem, a_partial_solution);
+      }
+
+      void add_solution_if_valid(solution_t&& a_solution, [[maybe_unused]] size_t a_depth, size_t a_thread_index,
+                                 thread_best_partial_t<solution_t>& a_best_partial)
+      {
+         if (!my_problem.is_solution_valid(a_solution))
+         {
+            DAK_SEARCH_COUNT_REJECTED(invalid_solution, a_depth, 1);
+            return;
+         }
+
+         if (my_best_partial)
+            keep_if_best_partial(a_solution, a_depth, a_best_partial);
+
+         a_solution.normalize();
+
+         if (!my_trace)
+         {
+            if (my_solutions.insert(std::move(a_solution)))
+               stop_if_enough_solutions();
+            return;
+         }
+
+         const std::int64_t insert_start_ns = my_trace->now();
+         bool was_contended = false;
+         const bool is_new = my_solutions.insert(std::move(a_solution), &was_contended);
+         my_trace->record(a_thread_index, "insert_solution", insert_start_ns, "contended", was_contended ? 1 : 0);
+         if (is_new)
+            stop_if_enough_solutions();
+      }
+
+      void stop_if_enough_solutions()
+      {
+         if (my_solutions_limit > 0 && my_solutions.size() >= my_solutions_limit)
+            my_stop_requested = true;
+      }
+
+      // Publish the thread counts and report progress if no other thread
+      // is already doing it. The progress may throw to stop the search.
+      void report_progress(worker_t& a_worker)
+      {
+         a_worker.published_counters.publish(a_worker.counts);
+
+         std::unique_lock lock(my_progress_lock, std::try_to_lock);
+         if (!lock.owns_lock())
+            return;
+
+         report_total_progress();
+      }
+
+      // Add up the thread counters and report the new nodes to the progress.
+      // Must be called with the progress lock held.
+      void report_total_progress()
+      {
+         const std::uint64_t total = my_counters.nodes_count();
+         const std::uint64_t new_nodes = total - my_reported_count;
+         my_reported_count = total;
+         my_progress.progress(size_t(new_nodes));
+      }
+
+      // Clear the rejections counted by the calling thread, which may have
+      // counted them for another search.
+      static void start_counting_rejections()
+      {
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+         rule_counts_t::thread_counts() = rule_counts_t();
+#endif
+      }
+
+      // Add the rejections counted by the calling thread to the progress counters.
+      void publish_rejections()
+      {
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+         my_counters.add_rule_counts(rule_counts_t::thread_counts());
+#endif
+      }
+
+      void stop_with_error(std::exception_ptr an_error)
+      {
+         std::lock_guard lock(my_progress_lock);
+         if (!my_error)
+            my_error = an_error;
+         my_stop_requested = true;
+      }
+
+      const problem_t&                       my_problem;
+      utility::progress_t&                   my_progress;
+      std::unique_ptr<progress_counters_t>   my_own_counters;
+      progress_counters_t&                   my_counters;
+      trace_recorder_t*                      my_trace = nullptr;
+      size_t                                 my_solutions_limit = 0;
+      best_partial_t<solution_t>*            my_best_partial = nullptr;
+      std::int64_t                           my_max_partial_score = 0;
+      std::vector<work_t>                    my_work;
+      size_t                                 my_work_depth = 0;
+      std::atomic<size_t>                    my_next_work = 0;
+      std::uint64_t                          my_reported_count = 0;
+      std::mutex                             my_progress_lock;
+      solution_store_t<solution_t>           my_solutions;
+      std::atomic<bool>                      my_stop_requested = false;
+      std::exception_ptr                     my_error;
+      std::promise<all_solutions_t>          my_async_solutions;
+   };
+}
+
+#endif /* DAK_SEARCH_SOLVE_H */
@@ -0,0 +1,280 @@
+#pragma once
+
+#ifndef DAK_SEARCH_TEXT_PARSER_H
+#define DAK_SEARCH_TEXT_PARSER_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Error found while parsing a text, with the line and column, both
+   // counted from one, where the error was found.
+
+   struct parse_error_t : std::runtime_error
+   {
+      parse_error_t(const std::string& a_message, size_t a_line, size_t a_column)
+      : std::runtime_error("line " + std::to_string(a_line) + ", column " + std::to_string(a_column) + ": " + a_message)
+      , my_line(a_line), my_column(a_column)
+      {
+      }
+
+      size_t line() const { return my_line; }
+      size_t column() const { return my_column; }
+
+   private:
+      size_t my_line = 0;
+      size_t my_column = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Single-pass tokenizer over a contiguous text.
+   //
+   // Words are views into the text and numbers are converted in place with
+   // from_chars, so nothing is allocated while parsing. The line and column
+   // are only computed when an error is reported.
+   //
+   // Carriage returns are treated as spaces, so texts with either line ends
+   // are parsed the same.
+
+   struct text_parser_t
+   {
+      text_parser_t(std::string_view a_text) : my_text(a_text) {}
+
+      // Check if the whole text was consumed.
+      bool is_at_end() const { return my_offset >= my_text.size(); }
+
+      // Skip spaces, then check if the end of the current line was reached.
+      bool is_at_end_of_line()
+      {
+         skip_spaces();
+         return is_at_end() || my_text[my_offset] == '\n';
+      }
+
+      // Skip spaces, but not line ends.
+      void skip_spaces()
+      {
+         while (!is_at_end() && is_space(my_text[my_offset]))
+            ++my_offset;
+      }
+
+      // Skip spaces and line ends.
+      void skip_white_space()
+      {
+         while (!is_at_end() && (is_space(my_text[my_offset]) || my_text[my_offset] == '\n'))
+            ++my_offset;
+      }
+
+      // Skip lines that are empty or only contain spaces, stopping
+      // at the start of the next line that has something else.
+      void skip_blank_lines()
+      {
+         for (size_t offset = my_offset; offset <= my_text.size(); ++offset)
+         {
+            if (offset == my_text.size())
+               my_offset = offset;
+            else if (my_text[offset] == '\n')
+               my_offset = offset + 1;
+            else if (!is_space(my_text[offset]))
+               break;
+         }
+      }
+
+      // Skip up to the given number of characters of the current line, whatever they are.
+      void skip_chars_on_line(size_t a_count)
+      {
+         for (; a_count > 0 && !is_at_end() && my_text[my_offset] != '\n'; --a_count)
+            ++my_offset;
+      }
+
+      // Skip the rest of the current line, including its end.
+      void skip_line()
+      {
+         const size_t line_end = my_text.find('\n', my_offset);
+         my_offset = (line_end == std::string_view::npos) ? my_text.size() : line_end + 1;
+      }
+
+      // Read the next word, skipping line ends. Empty at the end of the text.
+      std::string_view read_word()
+      {
+         skip_white_space();
+         return read_word_here();
+      }
+
+      // Read the next word of the current line. Empty at the end of the line.
+      std::string_view read_word_on_line()
+      {
+         skip_spaces();
+         return read_word_here();
+      }
+
+      // Peek at the next word of the current line without consuming anything.
+      std::string_view peek_word_on_line()
+      {
+         const size_t start = my_offset;
+         skip_spaces();
+         const std::string_view word = read_word_here();
+         my_offset = start;
+         return word;
+      }
+
+      // Read the next character of the current line, after skipping spaces.
+      // Throws if at the end of the line.
+      char read_char(const char* a_what)
+      {
+         if (is_at_end_of_line())
+            fail(std::string("expected ") + a_what);
+         return my_text[my_offset++];
+      }
+
+      // Consume the given character, which must be next. Throws otherwise.
+      void expect(char a_char)
+      {
+         if (is_at_end() || my_text[my_offset] != a_char)
+            fail(std::string("expected '") + a_char + "'");
+         ++my_offset;
+      }
+
+      // Consume the given word if it is next on the current line.
+      bool skip_if(std::string_view a_word)
+      {
+         skip_spaces();
+         if (my_text.substr(my_offset, a_word.size()) != a_word)
+            return false;
+         my_offset += a_word.size();
+         return true;
+      }
+
+      // Read a number on the current line, after skipping spaces.
+      // Throws if there is no number or if it does not fit the type.
+      template <class T>
+      T read_number(const char* a_what)
+      {
+         skip_spaces();
+         T value = T();
+         const char* first = my_text.data() + my_offset;
+         const auto [last, error] = std::from_chars(first, my_text.data() + my_text.size(), value);
+         if (error != std::errc())
+            fail(std::string("expected ") + a_what);
+         my_offset += size_t(last - first);
+         return value;
+      }
+
+      // Convert a whole word previously read to a number.
+      // Throws at the word if it is not entirely a number.
+      template <class T>
+      T to_number(std::string_view a_word, const char* a_what) const
+      {
+         T value = T();
+         const auto [last, error] = std::from_chars(a_word.data(), a_word.data() + a_word.size(), value);
+         if (error != std::errc() || last != a_word.data() + a_word.size())
+            fail_at(a_word, std::string("expected ") + a_what);
+         return value;
+      }
+
+      // Report an error at the current position.
+      [[noreturn]] void fail(const std::string& a_message) const
+      {
+         fail_at_offset(my_offset, a_message);
+      }
+
+      // Report an error at a word previously read.
+      [[noreturn]] void fail_at(std::string_view a_word, const std::string& a_message) const
+      {
+         fail_at_offset(size_t(a_word.data() - my_text.data()), a_message);
+      }
+
+   private:
+      static bool is_space(char a_char)
+      {
+         return a_char == ' ' || a_char == '\t' || a_char == '\r';
+      }
+
+      std::string_view read_word_here()
+      {
+         const size_t start = my_offset;
+         while (!is_at_end() && !is_space(my_text[my_offset]) && my_text[my_offset] != '\n')
+            ++my_offset;
+         return my_text.substr(start, my_offset - start);
+      }
+
+      [[noreturn]] void fail_at_offset(size_t an_offset, const std::string& a_message) const
+      {
+         an_offset = std::min(an_offset, my_text.size());
+         const std::string_view before = my_text.substr(0, an_offset);
+         const size_t line_start = before.rfind('\n');
+         const size_t line = 1 + size_t(std::count(before.begin(), before.end(), '\n'));
+         const size_t column = 1 + an_offset - (line_start == std::string_view::npos ? 0 : line_start + 1);
+         throw parse_error_t(a_message, line, column);
+      }
+
+      std::string_view  my_text;
+      size_t            my_offset = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Bring a whole text into a contiguous buffer for parsing.
+
+   // Read a whole file. Throws if the file cannot be read.
+   inline std::string load_text_file(const std::filesystem::path& a_path)
+   {
+      std::ifstream stream(a_path, std::ios::binary);
+      if (!stream)
+         throw std::runtime_error("could not open the file " + a_path.string());
+
+      std::string text;
+      stream.seekg(0, std::ios::end);
+      text.resize(size_t(stream.tellg()));
+      stream.seekg(0, std::ios::beg);
+      stream.read(text.data(), std::streamsize(text.size()));
+      return text;
+   }
+
+   // Convert a character to a narrow one. Wide characters outside of ASCII
+   // become question marks, which the parsers then report as errors.
+   template <class CHAR>
+   char narrow_char(CHAR a_char)
+   {
+      if constexpr (sizeof(CHAR) == 1)
+         return char(a_char);
+      else
+         return (std::uint32_t(a_char) < 128u) ? char(a_char) : '?';
+   }
+
+   // Convert a text to a narrow one.
+   template <class CHAR>
+   std::string narrow_text(const std::basic_string<CHAR>& a_text)
+   {
+      std::string text(a_text.size(), ' ');
+      std::transform(a_text.begin(), a_text.end(), text.begin(), narrow_char<CHAR>);
+      return text;
+   }
+
+   // Read the rest of a stream.
+   template <class CHAR>
+   std::string read_remaining_text(std::basic_istream<CHAR>& a_stream)
+   {
+      std::string text;
+      std::transform(std::istreambuf_iterator<CHAR>(a_stream), std::istreambuf_iterator<CHAR>(), std::back_inserter(text), narrow_char<CHAR>);
+      a_stream.setstate(std::ios::eofbit);
+      return text;
+   }
+}
+
+#endif /* DAK_SEARCH_TEXT_PARSER_H */
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef DAK_SEARCH_TEXT_WRITER_H
+#define DAK_SEARCH_TEXT_WRITER_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <charconv>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Buffered text writer.
+   //
+   // Text is accumulated in a large buffer, with numbers formatted by
+   // to_chars, and sent to the stream in big blocks, so writing many
+   // solutions takes few system calls. The remaining text is sent when
+   // the writer is flushed or destroyed.
+   //
+   // Without a stream, the text is only accumulated and can be retrieved.
+
+   struct text_writer_t
+   {
+      static constexpr size_t default_buffer_size = 256 * 1024;
+
+      // Create a writer that only accumulates the text.
+      text_writer_t() = default;
+
+      // Create a writer that sends the text to the stream.
+      text_writer_t(std::ostream& a_stream, size_t a_buffer_size = default_buffer_size)
+      : my_stream(&a_stream), my_buffer_size(a_buffer_size)
+      {
+         my_buffer.reserve(a_buffer_size + max_number_size);
+      }
+
+      ~text_writer_t()
+      {
+         flush();
+      }
+
+      text_writer_t(const text_writer_t&) = delete;
+      text_writer_t& operator=(const text_writer_t&) = delete;
+
+      // The text accumulated and not yet sent.
+      const std::string& text() const { return my_buffer; }
+
+      // Write a character.
+      text_writer_t& write(char a_char)
+      {
+         my_buffer.push_back(a_char);
+         return flush_if_full();
+      }
+
+      // Write a text.
+      text_writer_t& write(std::string_view a_text)
+      {
+         my_buffer.append(a_text);
+         return flush_if_full();
+      }
+
+      // Write an integer.
+      template <class T>
+      text_writer_t& write_number(T a_value)
+      {
+         static_assert(std::is_integral_v<T>);
+         char digits[max_number_size];
+         const auto [last, error] = std::to_chars(digits, digits + max_number_size, a_value);
+         my_buffer.append(digits, last);
+         return flush_if_full();
+      }
+
+      // Send the accumulated text to the stream.
+      void flush()
+      {
+         if (!my_stream || my_buffer.empty())
+            return;
+         my_stream->write(my_buffer.data(), std::streamsize(my_buffer.size()));
+         my_buffer.clear();
+      }
+
+   private:
+      static constexpr size_t max_number_size = 24;
+
+      text_writer_t& flush_if_full()
+      {
+         if (my_stream && my_buffer.size() >= my_buffer_size)
+            flush();
+         return *this;
+      }
+
+      std::ostream*  my_stream = nullptr;
+      size_t         my_buffer_size = default_buffer_size;
+      std::string    my_buffer;
+   };
+}
+
+#endif /* DAK_SEARCH_TEXT_WRITER_H */
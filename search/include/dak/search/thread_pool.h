@@ -0,0 +1,163 @@
+#pragma once
+
+#ifndef DAK_SEARCH_THREAD_POOL_H
+#define DAK_SEARCH_THREAD_POOL_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/search/arena.h"
+#include "dak/search/progress.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Pool of long-lived threads that all run the same task together.
+   //
+   // The threads are created once and wait for tasks between runs, so
+   // solving many small puzzles does not pay for creating and destroying
+   // threads each time. Each thread keeps the same index for its lifetime,
+   // which lets the tasks keep per-thread state warm from one run to the next.
+   // In particular, each thread has its own arena for temporary allocations.
+   //
+   // Only one task runs at a time: starting a task waits for the previous
+   // one to be complete. Tasks must not throw.
+   //
+   // The pool has at most as many threads as the progress counters have
+   // slots, since each searching thread publishes its counts to its own slot.
+
+   struct thread_pool_t
+   {
+      using task_t = std::function<void(size_t a_thread_index)>;
+      using completion_t = std::function<void()>;
+
+      // Create a pool with the given number of threads, or one thread per
+      // hardware thread when zero, up to the maximum number of threads.
+      thread_pool_t(size_t a_threads_count = 0)
+      {
+         if (a_threads_count == 0)
+            a_threads_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+         a_threads_count = std::min(a_threads_count, progress_counters_t::max_threads_count);
+
+         for (size_t i = 0; i < a_threads_count; ++i)
+            my_arenas.emplace_back(std::make_unique<arena_t>());
+
+         for (size_t i = 0; i < a_threads_count; ++i)
+            my_threads.emplace_back([this, i]() { run_thread(i); });
+      }
+
+      // Wait for the current task to complete and stop the threads.
+      ~thread_pool_t()
+      {
+         {
+            std::unique_lock lock(my_mutex);
+            my_idle_changed.wait(lock, [this]() { return is_idle(); });
+            my_stop_requested = true;
+         }
+         my_task_changed.notify_all();
+
+         for (auto& thread : my_threads)
+            thread.join();
+      }
+
+      thread_pool_t(const thread_pool_t&) = delete;
+      thread_pool_t& operator=(const thread_pool_t&) = delete;
+
+      size_t threads_count() const { return my_threads.size(); }
+
+      // The arena of the given thread. Only that thread may use it while a task runs.
+      arena_t& arena(size_t a_thread_index) { return *my_arenas[a_thread_index]; }
+
+      // Start running the task on all threads, passing each its index.
+      // The completion is called once, by the last thread to finish the task.
+      void start(task_t a_task, completion_t a_completion)
+      {
+         {
+            std::unique_lock lock(my_mutex);
+            my_idle_changed.wait(lock, [this]() { return is_idle(); });
+            my_task = std::move(a_task);
+            my_completion = std::move(a_completion);
+            my_running_count = my_threads.size();
+            my_generation += 1;
+         }
+         my_task_changed.notify_all();
+      }
+
+      // Run the task on all threads and wait for it to be done.
+      void run(task_t a_task)
+      {
+         std::promise<void> done;
+         start(std::move(a_task), [&done]() { done.set_value(); });
+         done.get_future().wait();
+      }
+
+   private:
+      // Must be called with the mutex held.
+      bool is_idle() const
+      {
+         return my_running_count == 0 && !my_completing;
+      }
+
+      void run_thread(size_t a_thread_index)
+      {
+         size_t generation = 0;
+         while (true)
+         {
+            task_t* task = nullptr;
+            {
+               std::unique_lock lock(my_mutex);
+               my_task_changed.wait(lock, [&]() { return my_stop_requested || my_generation != generation; });
+               if (my_stop_requested)
+                  return;
+               generation = my_generation;
+               task = &my_task;
+            }
+
+            (*task)(a_thread_index);
+
+            completion_t completion;
+            {
+               std::unique_lock lock(my_mutex);
+               if (--my_running_count > 0)
+                  continue;
+               completion = std::move(my_completion);
+               my_task = nullptr;
+               my_completing = true;
+            }
+
+            if (completion)
+               completion();
+
+            {
+               std::unique_lock lock(my_mutex);
+               my_completing = false;
+            }
+            my_idle_changed.notify_all();
+         }
+      }
+
+      std::vector<std::unique_ptr<arena_t>>   my_arenas;
+      std::vector<std::thread>                my_threads;
+      std::mutex                              my_mutex;
+      std::condition_variable                 my_task_changed;
+      std::condition_variable                 my_idle_changed;
+      task_t                                  my_task;
+      completion_t                            my_completion;
+      size_t                                  my_running_count = 0;
+      size_t                                  my_generation = 0;
+      bool                                    my_completing = false;
+      bool                                    my_stop_requested = false;
+   };
+}
+
+#endif /* DAK_SEARCH_THREAD_POOL_H */
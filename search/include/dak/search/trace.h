@@ -0,0 +1,176 @@
+#pragma once
+
+#ifndef DAK_SEARCH_TRACE_H
+#define DAK_SEARCH_TRACE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+
+namespace dak::search
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Timeline of what the solver threads did, to understand parallel scaling.
+   //
+   // The solver records events when a search_progress_t given to it has a
+   // trace recorder. Otherwise each hook is a single test of a null pointer,
+   // done per work item or per solution, never per node.
+   //
+   // Each thread records in its own ring buffer, so recording needs no lock.
+   // When a ring is full, the oldest events are overwritten: the trace keeps
+   // the end of the search. The caller thread, which splits the work before
+   // the threads start, has its own ring after the ones of the threads.
+   //
+   // A recorder must only be used by one solver at a time. The trace is
+   // written in the Chrome trace-event JSON format, which chrome://tracing
+   // and Perfetto can display.
+
+   struct trace_recorder_t
+   {
+      using clock_t = std::chrono::steady_clock;
+
+      // A recorded event. Events with a zero duration are instant events.
+      struct event_t
+      {
+         const char*    name = nullptr;
+         const char*    arg_name = nullptr;
+         std::uint64_t  arg = 0;
+         std::int64_t   start_ns = 0;
+         std::int64_t   duration_ns = 0;
+      };
+
+      // Create a recorder keeping up to the given number of events per thread.
+      trace_recorder_t(size_t an_events_per_thread = 1 << 14)
+      : my_events_per_thread(std::max<size_t>(an_events_per_thread, 1)), my_start(clock_t::now())
+      {
+      }
+
+      // Make sure there is a ring for each of the given threads and for the caller.
+      // Must not be called while threads are recording.
+      void prepare(size_t a_threads_count)
+      {
+         while (my_rings.size() < a_threads_count)
+            my_rings.emplace_back(std::make_unique<ring_t>(my_events_per_thread));
+         if (!my_caller_ring)
+            my_caller_ring = std::make_unique<ring_t>(my_events_per_thread);
+      }
+
+      // Current time, as passed to record().
+      std::int64_t now() const
+      {
+         return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - my_start).count();
+      }
+
+      // Record an event that started at the given time and ends now.
+      void record(size_t a_thread_index, const char* a_name, std::int64_t a_start_ns, const char* an_arg_name = nullptr, std::uint64_t an_arg = 0)
+      {
+         const std::int64_t end_ns = now();
+         ring(a_thread_index).add(event_t{ a_name, an_arg_name, an_arg, a_start_ns, std::max<std::int64_t>(end_ns - a_start_ns, 1) });
+      }
+
+      // Record an instant event.
+      void record_instant(size_t a_thread_index, const char* a_name, const char* an_arg_name = nullptr, std::uint64_t an_arg = 0)
+      {
+         ring(a_thread_index).add(event_t{ a_name, an_arg_name, an_arg, now(), 0 });
+      }
+
+      // Index used to record the events of the caller thread.
+      static constexpr size_t caller_thread = size_t(-1);
+
+      // Events recorded by the given thread, oldest first.
+      std::vector<event_t> events(size_t a_thread_index) const
+      {
+         const ring_t* recorded = (a_thread_index == caller_thread) ? my_caller_ring.get()
+                                : (a_thread_index < my_rings.size()) ? my_rings[a_thread_index].get()
+                                : nullptr;
+         return recorded ? recorded->ordered() : std::vector<event_t>();
+      }
+
+      // Number of threads that have a ring, not counting the caller.
+      size_t threads_count() const { return my_rings.size(); }
+
+      // Write all events in the Chrome trace-event JSON format.
+      // The caller thread is shown after the solver threads.
+      void write_chrome_trace(std::ostream& a_stream) const
+      {
+         bool is_first = true;
+         const auto write_thread = [&a_stream, &is_first, this](size_t a_thread_index, size_t a_tid, const char* a_thread_name)
+         {
+            a_stream << (is_first ? "\n" : ",\n")
+                     << "  { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << a_tid
+                     << ", \"args\": { \"name\": \"" << a_thread_name << (a_thread_index == caller_thread ? "" : " ");
+            if (a_thread_index != caller_thread)
+               a_stream << a_thread_index;
+            a_stream << "\" } }";
+            is_first = false;
+
+            for (const event_t& event : events(a_thread_index))
+            {
+               a_stream << ",\n  { \"name\": \"" << event.name << "\", \"ph\": \"" << (event.duration_ns ? "X" : "i")
+                        << "\", \"pid\": 1, \"tid\": " << a_tid << ", \"ts\": " << double(event.start_ns) / 1000.;
+               if (event.duration_ns)
+                  a_stream << ", \"dur\": " << double(event.duration_ns) / 1000.;
+               else
+                  a_stream << ", \"s\": \"t\"";
+               if (event.arg_name)
+                  a_stream << ", \"args\": { \"" << event.arg_name << "\": " << event.arg << " }";
+               a_stream << " }";
+            }
+         };
+
+         a_stream << "{ \"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+         for (size_t i = 0; i < my_rings.size(); ++i)
+            write_thread(i, i, "worker");
+         write_thread(caller_thread, my_rings.size(), "caller");
+         a_stream << "\n] }\n";
+      }
+
+   private:
+      // Fixed-size ring of events written by a single thread.
+      // Rings are aligned on cache lines to avoid false sharing of their positions.
+      struct alignas(64) ring_t
+      {
+         ring_t(size_t a_capacity) : my_events(a_capacity) {}
+
+         void add(const event_t& an_event)
+         {
+            my_events[my_next] = an_event;
+            my_next = (my_next + 1) % my_events.size();
+            my_count = std::min(my_count + 1, my_events.size());
+         }
+
+         std::vector<event_t> ordered() const
+         {
+            std::vector<event_t> events;
+            events.reserve(my_count);
+            const size_t first = (my_next + my_events.size() - my_count) % my_events.size();
+            for (size_t i = 0; i < my_count; ++i)
+               events.push_back(my_events[(first + i) % my_events.size()]);
+            return events;
+         }
+
+         std::vector<event_t> my_events;
+         size_t               my_next = 0;
+         size_t               my_count = 0;
+      };
+
+      ring_t& ring(size_t a_thread_index)
+      {
+         return (a_thread_index < my_rings.size()) ? *my_rings[a_thread_index] : *my_caller_ring;
+      }
+
+      size_t                                 my_events_per_thread;
+      clock_t::time_point                    my_start;
+      std::vector<std::unique_ptr<ring_t>>   my_rings;
+      std::unique_ptr<ring_t>                my_caller_ring;
+   };
+}
+
+#endif /* DAK_SEARCH_TRACE_H */
@@ -25,38 +25,24 @@ namespace dak::six_eight
       }
 
       // Convert to integer for array indexing.
-      int as_int() const { return int(my_dir); }
+      constexpr int as_int() const { return int(my_dir); }
 
       // The corresponding X-coordinate delta of the direction.
-      int delta_x() const
-      {
-         switch (my_dir)
-         {
-            default:
-            case 0: return -1;
-            case 1: return  0;
-            case 2: return  1;
-            case 3: return  0;
-         }
-      }
+      constexpr int delta_x() const { return deltas_x[my_dir]; }
 
       // The corresponding Y-coordinate delta of the direction.
-      int delta_y() const
-      {
-         switch (my_dir)
-         {
-            default:
-            case 0: return  0;
-            case 1: return -1;
-            case 2: return  0;
-            case 3: return  1;
-         }
-      }
+      constexpr int delta_y() const { return deltas_y[my_dir]; }
+
+      // The corresponding delta of the packed key of positions.
+      constexpr int delta_key() const { return delta_y() * 256 + delta_x(); }
 
       // Direction comparison.
       auto operator<=>(const direction_t& an_other) const = default;
 
    private:
+      static constexpr std::int8_t deltas_x[4] = { -1,  0,  1,  0 };
+      static constexpr std::int8_t deltas_y[4] = {  0, -1,  0,  1 };
+
       std::uint8_t my_dir = 0;
    };
 
@@ -0,0 +1,32 @@
+#pragma once
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/six_eight/solution.h"
+
+#include "dak/search/text_writer.h"
+
+#include <filesystem>
+#include <iostream>
+
+
+namespace dak::six_eight
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Write solutions as text, in the format read by parse_solutions.
+   //
+   // The text is formatted in a large buffer, which is much faster than
+   // formatting each tile through the stream.
+
+   // Write a solution: eight rows showing the tile covering each block,
+   // each followed by one of the placed tiles.
+   void write_solution(search::text_writer_t& a_writer, const solution_t& a_solution);
+
+   // Write solutions, each followed by a blank line.
+   void write_solutions(search::text_writer_t& a_writer, const all_solutions_t& some_solutions);
+   void write_solutions(std::ostream& a_stream, const all_solutions_t& some_solutions);
+
+   // Save solutions to a file.
+   void save_solutions(const std::filesystem::path& a_path, const all_solutions_t& some_solutions);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/six_eight/puzzle.h"
+#include "dak/six_eight/solution.h"
+
+#include "dak/search/text_parser.h"
+
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+
+namespace dak::six_eight
+{
+   using parse_error_t = search::parse_error_t;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Parse puzzles and solutions from text.
+   //
+   // The text is parsed in a single pass, without copying. Errors throw
+   // a parse_error_t giving the line and column of the error.
+
+   // Parse a tile written as its id followed by its rotation,
+   // for example: "Q rotated 2 times".
+   tile_t parse_tile(std::string_view a_text);
+
+   // Parse a puzzle written as the ids of its eight tiles.
+   puzzle_t parse_puzzle(std::string_view a_text);
+
+   // Parse a list of puzzles, each written as the ids of its eight tiles.
+   std::vector<puzzle_t> parse_puzzles(std::string_view a_text);
+
+   // Parse a single solution, written as its eight rows, each followed
+   // by one of its placed tiles.
+   solution_t parse_solution(std::string_view a_text);
+
+   // Parse all solutions of a solutions text, separated by blank lines.
+   all_solutions_t parse_solutions(std::string_view a_text);
+
+   // Load a file containing a list of puzzles.
+   std::vector<puzzle_t> load_puzzles(const std::filesystem::path& a_path);
+
+   // Load a solutions file.
+   all_solutions_t load_solutions(const std::filesystem::path& a_path);
+}
@@ -8,6 +8,7 @@
 #include <dak/solver/problem.h>
 
 #include <algorithm>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -21,14 +22,40 @@ namespace dak::six_eight
    struct puzzle_t : solver::problem_t
    {
       // Sub puzzle
+      //
+      // The other tiles can be allocated from a memory resource, usually
+      // the arena of the solver thread. Containers of sub-puzzles that use
+      // a memory resource pass it down to the sub-puzzles they contain.
 
       struct sub_problem_t
       {
-         tile_t               tile_to_place;
-         std::vector<tile_t>  other_tiles;
-         position_t           position_to_fill;
+         using allocator_type = std::pmr::polymorphic_allocator<>;
+
+         sub_problem_t() = default;
+         sub_problem_t(const sub_problem_t&) = default;
+         sub_problem_t(sub_problem_t&&) = default;
+         sub_problem_t& operator=(const sub_problem_t&) = default;
+         sub_problem_t& operator=(sub_problem_t&&) = default;
+
+         sub_problem_t(const allocator_type& an_allocator)
+         : other_tiles(an_allocator) {}
+
+         sub_problem_t(const sub_problem_t& an_other, const allocator_type& an_allocator)
+         : tile_to_place(an_other.tile_to_place)
+         , other_tiles(an_other.other_tiles, an_allocator)
+         , position_to_fill(an_other.position_to_fill) {}
+
+         sub_problem_t(sub_problem_t&& an_other, const allocator_type& an_allocator)
+         : tile_to_place(an_other.tile_to_place)
+         , other_tiles(std::move(an_other.other_tiles), an_allocator)
+         , position_to_fill(an_other.position_to_fill) {}
+
+         tile_t                     tile_to_place;
+         std::pmr::vector<tile_t>   other_tiles;
+         position_t                 position_to_fill;
       };
 
+      using sub_problems_t = std::pmr::vector<sub_problem_t>;
       using tiles_t = std::vector<tile_t>;
 
       // Create a puzzle.
@@ -41,17 +68,21 @@ namespace dak::six_eight
       // Solver interaction.
 
       // Create the initial list of sub-puzzles to solve.
-      std::vector<sub_problem_t> create_initial_sub_problems() const;
+      sub_problems_t create_initial_sub_problems() const;
 
       // Create sub-puzzles from a given sub-puzzle that has its tile placed.
-      std::vector<sub_problem_t> create_sub_problems(
+      // The sub-puzzles are allocated from the given memory resource.
+      sub_problems_t create_sub_problems(
          const sub_problem_t& a_current_sub_problem,
-         const solution_t& a_partial_solution) const;
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
 
       // Get the list of potential position for the tile-to-be-placed of the given sub-puzzle.
-      virtual std::vector<solution_t::part_t> get_sub_problem_potential_parts(
+      // The parts are allocated from the given memory resource.
+      virtual solution_t::parts_t get_sub_problem_potential_parts(
          const sub_problem_t& a_current_sub_problem,
-         const solution_t& a_partial_solution) const;
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
 
       // Verify if there are more sub-puzzles to be created from the given sub-puzzle.
       bool has_more_sub_problems(const sub_problem_t& a_current_sub_problem) const;
@@ -6,6 +6,7 @@
 #include "dak/six_eight/tile.h"
 #include "dak/solver/solution.h"
 
+#include <memory_resource>
 #include <set>
 #include <vector>
 #include <optional>
@@ -34,6 +35,7 @@ namespace dak::six_eight
       };
 
       using tiles_by_pos_t = part_t[8];
+      using parts_t = std::pmr::vector<part_t>;
 
       // Create a new solution.
       solution_t();
@@ -83,6 +85,9 @@ namespace dak::six_eight
       std::strong_ordering operator<=>(const solution_t& another_solution) const;
       bool operator==(const solution_t& another_solution) const { return operator<=>(another_solution) == 0; }
 
+      // Hash of the solution, equal for solutions that compare equal.
+      std::uint64_t hash() const;
+
       // Add a similar solution to this solution.
       void add_similar_solution(const solution_t& another_solution);
 
@@ -0,0 +1,56 @@
+#include "dak/six_eight/format.h"
+
+#include <fstream>
+
+
+namespace dak::six_eight
+{
+   namespace
+   {
+      constexpr int rows_count = 8;
+      constexpr int row_width = 6;
+   }
+
+   void write_solution(search::text_writer_t& a_writer, const solution_t& a_solution)
+   {
+      for (int y = 0; y < rows_count; ++y)
+      {
+         char row[row_width];
+         for (int x = 0; x < row_width; ++x)
+         {
+            const tile_t::id_t id = a_solution.tile_at(x, y).id();
+            row[x] = id ? id : ' ';
+         }
+         a_writer.write(std::string_view(row, row_width));
+
+         if (size_t(y) < a_solution.tiles_count())
+         {
+            const auto& placed = a_solution.tiles()[y];
+            a_writer.write("    ").write_number(placed.pos.x()).write('/').write_number(placed.pos.y()).write(' ');
+            a_writer.write(placed.tile.id()).write(" rotated ").write_number(placed.tile.get_rotation()).write(" times ");
+         }
+         a_writer.write('\n');
+      }
+   }
+
+   void write_solutions(search::text_writer_t& a_writer, const all_solutions_t& some_solutions)
+   {
+      for (const solution_t& solution : some_solutions)
+      {
+         write_solution(a_writer, solution);
+         a_writer.write('\n');
+      }
+   }
+
+   void write_solutions(std::ostream& a_stream, const all_solutions_t& some_solutions)
+   {
+      search::text_writer_t writer(a_stream);
+      write_solutions(writer, some_solutions);
+   }
+
+   void save_solutions(const std::filesystem::path& a_path, const all_solutions_t& some_solutions)
+   {
+      std::ofstream stream(a_path);
+      write_solutions(stream, some_solutions);
+   }
+}
@@ -0,0 +1,159 @@
+#include "dak/six_eight/parse.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+
+namespace dak::six_eight
+{
+   using search::text_parser_t;
+
+   namespace
+   {
+      constexpr size_t puzzle_tiles_count = 8;
+      constexpr size_t row_width = 6;
+      constexpr size_t rows_count = 8;
+
+      bool is_known_id(char an_id)
+      {
+         static const std::array<bool, 256> known_ids = []()
+         {
+            std::array<bool, 256> known = { false };
+            for (const tile_t::id_t id : tile_t::get_all_ids())
+               known[std::uint8_t(id)] = true;
+            return known;
+         }();
+
+         return known_ids[std::uint8_t(an_id)];
+      }
+
+      tile_t to_tile(const text_parser_t& a_parser, std::string_view a_word)
+      {
+         if (a_word.size() != 1 || !is_known_id(a_word[0]))
+            a_parser.fail_at(a_word, "unknown tile " + std::string(a_word));
+         return tile_t(a_word[0]);
+      }
+
+      // Read a tile id followed by its rotation.
+      tile_t read_tile(text_parser_t& a_parser)
+      {
+         tile_t tile = to_tile(a_parser, a_parser.read_word_on_line());
+         if (!a_parser.skip_if("rotated"))
+            a_parser.fail("expected 'rotated'");
+         const int rotation = a_parser.read_number<int>("a rotation");
+         if (!a_parser.skip_if("times"))
+            a_parser.fail("expected 'times'");
+         return tile.rotate_in_place(rotation);
+      }
+
+      // Read the eight tiles of a puzzle. Returns false if the text has no more puzzles.
+      bool read_puzzle(text_parser_t& a_parser, puzzle_t& a_puzzle)
+      {
+         std::vector<tile_t> tiles;
+         for (std::string_view word = a_parser.read_word(); !word.empty(); word = a_parser.read_word())
+         {
+            tiles.push_back(to_tile(a_parser, word));
+            if (tiles.size() == puzzle_tiles_count)
+            {
+               a_puzzle = puzzle_t(tiles);
+               return true;
+            }
+         }
+
+         if (!tiles.empty())
+            a_parser.fail("expected the eight tiles of the puzzle");
+
+         return false;
+      }
+
+      // Read the rows of a solution. Each row shows the ids of the tiles
+      // covering it and can be followed by a placed tile. Only the placed
+      // tiles are kept.
+      solution_t read_solution(text_parser_t& a_parser)
+      {
+         solution_t solution;
+         for (size_t row = 0; row < rows_count && !a_parser.is_at_end(); ++row)
+         {
+            a_parser.skip_chars_on_line(row_width);
+            if (!a_parser.is_at_end_of_line())
+            {
+               const int x = a_parser.read_number<int>("a position");
+               a_parser.expect('/');
+               const int y = a_parser.read_number<int>("a position");
+               const tile_t tile = read_tile(a_parser);
+               if (!a_parser.is_at_end_of_line())
+                  a_parser.fail("unexpected text after the tile");
+               solution.add_tile(tile, position_t(x, y));
+            }
+            a_parser.skip_line();
+         }
+         return solution;
+      }
+   }
+
+   tile_t parse_tile(std::string_view a_text)
+   {
+      text_parser_t parser(a_text);
+      const tile_t tile = read_tile(parser);
+      if (!parser.is_at_end_of_line())
+         parser.fail("unexpected text after the tile");
+      return tile;
+   }
+
+   puzzle_t parse_puzzle(std::string_view a_text)
+   {
+      text_parser_t parser(a_text);
+      puzzle_t puzzle;
+      if (!read_puzzle(parser, puzzle))
+         parser.fail("expected the eight tiles of the puzzle");
+      if (!parser.read_word().empty())
+         parser.fail("unexpected text after the puzzle");
+      return puzzle;
+   }
+
+   std::vector<puzzle_t> parse_puzzles(std::string_view a_text)
+   {
+      std::vector<puzzle_t> puzzles;
+      text_parser_t parser(a_text);
+      puzzle_t puzzle;
+      while (read_puzzle(parser, puzzle))
+         puzzles.push_back(puzzle);
+      return puzzles;
+   }
+
+   solution_t parse_solution(std::string_view a_text)
+   {
+      text_parser_t parser(a_text);
+      parser.skip_blank_lines();
+      return read_solution(parser);
+   }
+
+   all_solutions_t parse_solutions(std::string_view a_text)
+   {
+      all_solutions_t solutions;
+
+      // The count of solutions written before them is ignored.
+      // Solutions are usually written in order, so each goes at the end.
+      text_parser_t parser(a_text);
+      for (parser.skip_blank_lines(); !parser.is_at_end(); parser.skip_blank_lines())
+      {
+         if (parser.peek_word_on_line() == "solutions:")
+            parser.skip_line();
+         else
+            solutions.emplace_hint(solutions.end(), read_solution(parser));
+      }
+
+      return solutions;
+   }
+
+   std::vector<puzzle_t> load_puzzles(const std::filesystem::path& a_path)
+   {
+      return parse_puzzles(search::load_text_file(a_path));
+   }
+
+   all_solutions_t load_solutions(const std::filesystem::path& a_path)
+   {
+      return parse_solutions(search::load_text_file(a_path));
+   }
+}
@@ -27,41 +27,41 @@ namespace dak::six_eight
    }
 
    // Create the initial list of sub-puzzles to solve.
-   std::vector<puzzle_t::sub_problem_t> puzzle_t::create_initial_sub_problems() const
+   puzzle_t::sub_problems_t puzzle_t::create_initial_sub_problems() const
    {
       sub_problem_t sub_puzzle;
       sub_puzzle.tile_to_place = my_initial_tiles[0];
-      sub_puzzle.other_tiles = my_initial_tiles;
+      sub_puzzle.other_tiles.assign(my_initial_tiles.begin(), my_initial_tiles.end());
       sub_puzzle.position_to_fill = position_t(0, 0);
       return create_sub_problems(sub_puzzle, solution_t());
    }
 
-   std::vector<puzzle_t::sub_problem_t> puzzle_t::create_sub_problems(
+   puzzle_t::sub_problems_t puzzle_t::create_sub_problems(
       const sub_problem_t& a_current_sub_problem,
-      const solution_t& a_partial_solution) const
+      const solution_t& a_partial_solution,
+      std::pmr::memory_resource* a_resource) const
    {
+      sub_problems_t sub_puzzles(a_resource);
+
       if (a_current_sub_problem.other_tiles.size() <= 0) {
          // std::cout << "No more tiles for partial solution: " << a_partial_solution << std::endl;
-         return {};
+         return sub_puzzles;
       }
 
       position_t position_to_fill = a_partial_solution.get_next_position_to_fill();
       if (a_partial_solution.is_occupied(position_to_fill)) {
          // std::cout << "Cannot find unoccupied position for partial solution: " << a_partial_solution << std::endl;
-         return {};
+         return sub_puzzles;
       }
 
-      std::vector<sub_problem_t> sub_puzzles;
-
-      std::vector<tile_t> other_tiles(a_current_sub_problem.other_tiles);
+      std::pmr::vector<tile_t> other_tiles(a_current_sub_problem.other_tiles, a_resource);
       for (size_t i = 0; i < other_tiles.size(); ++i) {
          const int possible_rotations = other_tiles[0].get_description().possible_rotations;
          for (int rotation = 0; rotation < possible_rotations; ++rotation) {
-            sub_problem_t sub_puzzle;
+            sub_problem_t& sub_puzzle = sub_puzzles.emplace_back();
             sub_puzzle.tile_to_place = other_tiles[0].rotate(rotation);
-            sub_puzzle.other_tiles = { other_tiles.begin() + 1, other_tiles.end() };
+            sub_puzzle.other_tiles.assign(other_tiles.begin() + 1, other_tiles.end());
             sub_puzzle.position_to_fill = position_to_fill;
-            sub_puzzles.emplace_back(sub_puzzle);
          }
          std::rotate(other_tiles.begin(), other_tiles.begin() + 1, other_tiles.end());
       }
@@ -76,16 +76,18 @@ namespace dak::six_eight
    }
 
    // Get the list of potential position for the tile-to-be-placed of the given sub-puzzle.
-   std::vector<solution_t::part_t> puzzle_t::get_sub_problem_potential_parts(
+   solution_t::parts_t puzzle_t::get_sub_problem_potential_parts(
       const sub_problem_t& a_current_sub_problem,
-      const solution_t& a_partial_solution) const
+      const solution_t& a_partial_solution,
+      std::pmr::memory_resource* a_resource) const
    {
       // std::cout << "Created part for " << current_sub_puzzle->tile_to_place.id() << " in\n" << *std::dynamic_pointer_cast<six_eight::solution_t>(a_partial_solution) << std::endl;
 
-      return { solution_t::part_t(
+      solution_t::parts_t parts(a_resource);
+      parts.emplace_back(
          a_current_sub_problem.tile_to_place,
-         a_current_sub_problem.position_to_fill) };
-
+         a_current_sub_problem.position_to_fill);
+      return parts;
    }
 
    ////////////////////////////////////////////////////////////////////////////
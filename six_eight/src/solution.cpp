@@ -1,6 +1,7 @@
 #include "dak/six_eight/solution.h"
 
 #include <algorithm>
+#include <cstring>
 #include <set>
 #include <map>
 #include <exception>
@@ -21,7 +22,7 @@ namespace dak::six_eight
    //    - Add a solution if it is not already known.
    solution_t::solution_t()
    {
-      memset(my_tiles_at_pos, 0, sizeof(my_tiles_at_pos));
+      std::memset(my_tiles_at_pos, 0, sizeof(my_tiles_at_pos));
    }
 
    void solution_t::add_tile(const tile_t& a_tile, const position_t& a_pos)
@@ -129,6 +130,16 @@ namespace dak::six_eight
            : std::strong_ordering::less;
    }
 
+   std::uint64_t solution_t::hash() const
+   {
+      // FNV-1a over the same grid that is compared.
+      std::uint64_t hash = 0xcbf29ce484222325ull;
+      const auto* ids = reinterpret_cast<const unsigned char*>(my_tiles_at_pos);
+      for (size_t i = 0; i < sizeof(my_tiles_at_pos); ++i)
+         hash = (hash ^ ids[i]) * 0x100000001b3ull;
+      return hash;
+   }
+
    void solution_t::add_similar_solution(const solution_t& /*another_solution*/)
    {
       // Similar solutions are actually identical for this puzzle type.
@@ -1,11 +1,53 @@
 #include "dak/six_eight/six_eight.h"
 #include "dak/six_eight/stream.h"
+#include "dak/six_eight/format.h"
+#include "dak/six_eight/parse.h"
 
-#include <sstream>
 #include <string>
 
 namespace dak::six_eight
 {
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Reading is done by the text parser. Parse errors fail the stream.
+
+   namespace
+   {
+      template <class CHAR, class T, class PARSE>
+      std::basic_istream<CHAR>& parse_text(std::basic_istream<CHAR>& a_stream, const std::string& a_text, T& a_value, PARSE a_parse)
+      {
+         try
+         {
+            a_value = a_parse(a_text);
+         }
+         catch (const parse_error_t&)
+         {
+            a_stream.setstate(std::ios::failbit);
+         }
+         return a_stream;
+      }
+
+      template <class CHAR, class T, class PARSE>
+      std::basic_istream<CHAR>& parse_remaining_text(std::basic_istream<CHAR>& a_stream, T& a_value, PARSE a_parse)
+      {
+         return parse_text(a_stream, search::read_remaining_text(a_stream), a_value, a_parse);
+      }
+
+      template <class CHAR, class T, class PARSE>
+      std::basic_istream<CHAR>& parse_words(std::basic_istream<CHAR>& a_stream, size_t a_count, T& a_value, PARSE a_parse)
+      {
+         std::basic_string<CHAR> text, word;
+         for (size_t i = 0; i < a_count; ++i)
+         {
+            if (!(a_stream >> word))
+               return a_stream;
+            text += word;
+            text += CHAR(' ');
+         }
+         return parse_text(a_stream, search::narrow_text(text), a_value, a_parse);
+      }
+   }
+
    std::ostream& operator<<(std::ostream& a_stream, const direction_t& a_direction)
    {
       switch (a_direction.as_int())
@@ -74,200 +116,62 @@ namespace dak::six_eight
 
    std::istream& operator>>(std::istream& a_stream, tile_t& a_tile)
    {
-      int tile_id = 0;
-      int rotation = 0;
-      std::string word1;
-      std::string word2;
-      a_stream >> tile_id >> word1 >> word2 >> rotation;
-      if (a_stream)
-         a_tile = tile_t(tile_id).rotate_in_place(rotation);
-      return a_stream;
+      return parse_words(a_stream, 4, a_tile, parse_tile);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, tile_t& a_tile)
    {
-      wchar_t tile_id = 0;
-      int rotation = 0;
-      std::wstring word1;
-      std::wstring word2;
-      a_stream >> tile_id >> word1 >> word2 >> rotation;
-      if (a_stream)
-         a_tile = tile_t(char(tile_id)).rotate_in_place(rotation);
-      return a_stream;
+      return parse_words(a_stream, 4, a_tile, parse_tile);
    }
 
    std::ostream& operator<<(std::ostream& a_stream, const solution_t& a_solution)
    {
-      for (int y = 0; y < 8; ++y) {
-         for (int x = 0; x < 6; ++x) {
-            tile_t::id_t id = a_solution.tile_at(x, y).id();
-            a_stream << (id ? id : ' ');
-         }
-         
-         if (y < a_solution.tiles_count()) {
-            const auto& placed = a_solution.tiles()[y];
-            a_stream << "    " << placed.pos << " " << placed.tile;
-         }
-         a_stream << std::endl;
-      }
+      search::text_writer_t writer(a_stream);
+      write_solution(writer, a_solution);
       return a_stream;
    }
 
    std::wostream& operator<<(std::wostream& a_stream, const solution_t& a_solution)
    {
-      for (int y = 0; y < 8; ++y) {
-         for (int x = 0; x < 6; ++x) {
-            tile_t::id_t id = a_solution.tile_at(x, y).id();
-            a_stream << (id ? id : ' ');
-         }
-         
-         if (y < a_solution.tiles_count()) {
-            const auto& placed = a_solution.tiles()[y];
-            a_stream << "    " << placed.pos << " " << placed.tile;
-         }
-         a_stream << std::endl;
-      }
-      return a_stream;
+      search::text_writer_t writer;
+      write_solution(writer, a_solution);
+      return a_stream << writer.text().c_str();
    }
 
    std::istream& operator>>(std::istream& a_stream, solution_t& a_solution)
    {
-      std::string validity;
-      a_stream >> validity;
-      a_solution = solution_t();
-      while (a_stream)
-      {
-         position_t pos;
-         a_stream >> pos;
-         std::string column;
-         a_stream >> column;
-         tile_t tile;
-         a_stream >> tile;
-         if (tile.is_valid())
-            a_solution.add_tile(tile, pos);
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, a_solution, parse_solution);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, solution_t& a_solution)
    {
-      std::wstring validity;
-      a_stream >> validity;
-      a_solution = solution_t();
-      while (a_stream)
-      {
-         position_t pos;
-         a_stream >> pos;
-         std::wstring column;
-         a_stream >> column;
-         tile_t tile;
-         a_stream >> tile;
-         if (tile.is_valid())
-            a_solution.add_tile(tile, pos);
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, a_solution, parse_solution);
    }
 
    std::ostream& operator<<(std::ostream& a_stream, const all_solutions_t& some_solutions)
    {
-      a_stream << "solutions: " << some_solutions.size() << "\n";
-      for (const auto& sol : some_solutions)
-         a_stream << sol << "\n";
-
+      search::text_writer_t writer(a_stream);
+      writer.write("solutions: ").write_number(some_solutions.size()).write('\n');
+      write_solutions(writer, some_solutions);
       return a_stream;
    }
 
    std::wostream& operator<<(std::wostream& a_stream, const all_solutions_t& some_solutions)
    {
-      a_stream << L"solutions: " << some_solutions.size() << L"\n";
-      for (const auto& sol : some_solutions)
-         a_stream << sol << L"\n";
-
-      return a_stream;
+      search::text_writer_t writer;
+      writer.write("solutions: ").write_number(some_solutions.size()).write('\n');
+      write_solutions(writer, some_solutions);
+      return a_stream << writer.text().c_str();
    }
 
    std::istream& operator>>(std::istream& a_stream, all_solutions_t& some_solutions)
    {
-      some_solutions.clear();
-
-      enum { none, found_validity } state = none;
-
-      std::string solution_buffer;
-      char line_buffer[256] = { 0 };
-
-      while (a_stream.getline(line_buffer, sizeof(line_buffer) - 1))
-      {
-         std::string line(line_buffer);
-         solution_buffer.append(line);
-
-         if (line.find_first_of("\r\n") == std::string::npos)
-            solution_buffer.append("\n");
-
-         if (state == none)
-         {
-            if (line.find("valid") != std::string::npos)
-               state = found_validity;
-            else
-               solution_buffer.clear();
-         }
-         else if (state == found_validity)
-         {
-            if (line.find_first_not_of(" \t\r\n") == std::string::npos)
-            {
-               std::istringstream sol_stream(solution_buffer);
-               solution_t solution;
-               sol_stream >> solution;
-               some_solutions.insert(std::move(solution));
-               solution_buffer.clear();
-               state = none;
-            }
-         }
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, some_solutions, parse_solutions);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, all_solutions_t& some_solutions)
    {
-      some_solutions.clear();
-
-      enum { none, found_validity } state = none;
-
-      std::wstring solution_buffer;
-      wchar_t line_buffer[256] = { 0 };
-
-      while (a_stream.getline(line_buffer, sizeof(line_buffer) - 1))
-      {
-         std::wstring line(line_buffer);
-         solution_buffer.append(line);
-
-         if (line.find_first_of(L"\r\n") == std::wstring::npos)
-            solution_buffer.append(L"\n");
-
-         if (state == none)
-         {
-            if (line.find(L"valid") != std::wstring::npos)
-               state = found_validity;
-            else
-               solution_buffer.clear();
-         }
-         else if (state == found_validity)
-         {
-            if (line.find_first_not_of(L" \t\r\n") == std::wstring::npos)
-            {
-               std::wistringstream sol_stream(solution_buffer);
-               solution_t solution;
-               sol_stream >> solution;
-               some_solutions.insert(std::move(solution));
-               solution_buffer.clear();
-               state = none;
-            }
-         }
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, some_solutions, parse_solutions);
    }
 
    std::ostream& operator<<(std::ostream& a_stream, const puzzle_t& a_puzzle)
@@ -288,50 +192,12 @@ namespace dak::six_eight
 
    std::istream& operator>>(std::istream& a_stream, puzzle_t& a_puzzle)
    {
-      std::vector<tile_t> tiles;
-
-      std::string word;
-      while (a_stream >> word)
-      {
-         char id;
-         if (std::istringstream(word) >> id)
-         {
-            tile_t tile(id);
-            if (tile.is_valid())
-               tiles.push_back(tile);
-         }
-         if (tiles.size() == 8)
-            break;
-      }
-
-      if (tiles.size() == 8)
-         a_puzzle = puzzle_t(tiles);
-
-      return a_stream;
+      return parse_words(a_stream, 8, a_puzzle, parse_puzzle);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, puzzle_t& a_puzzle)
    {
-      std::vector<tile_t> tiles;
-
-      std::wstring word;
-      while (a_stream >> word)
-      {
-         int id;
-         if (std::wistringstream(word) >> id)
-         {
-            tile_t tile(id);
-            if (tile.is_valid())
-               tiles.push_back(tile);
-         }
-         if (tiles.size() == 8)
-            break;
-      }
-
-      if (tiles.size() == 8)
-         a_puzzle = puzzle_t(tiles);
-
-      return a_stream;
+      return parse_words(a_stream, 8, a_puzzle, parse_puzzle);
    }
 
 
@@ -1,7 +1,11 @@
 #include "dak/six_eight/six_eight.h"
+#include "dak/six_eight/format.h"
+#include "dak/six_eight/parse.h"
 #include "dak/six_eight/stream.h"
-#include "dak/solver/solve.h"
-#include "dak/utility/stream_progress.h"
+#include "dak/search/estimate.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/search/thread_pool.h"
 #include "dak/utility/stopwatch.h"
 
 #include <iostream>
@@ -11,7 +15,18 @@
 using namespace std;
 using namespace dak::six_eight;
 using namespace dak::utility;
-using namespace dak::solver;
+using namespace dak::search;
+
+static void print_counters(const progress_counters_t& some_counters)
+{
+   cout << "nodes: " << some_counters.nodes_count()
+        << " (" << uint64_t(some_counters.nodes_per_second()) << " nodes/s), "
+        << "pruned: " << some_counters.prunes_count() << endl;
+   cout << "nodes per depth:";
+   for (const uint64_t count : some_counters.depth_histogram())
+      cout << " " << count;
+   cout << endl;
+}
 
 int main(int arg_count, char** arg_values)
 {
@@ -22,42 +37,57 @@ int main(int arg_count, char** arg_values)
          cout << "Provide a puzzle file name." << endl;
          return 1;
    }
+
+   bool estimate_only = false;
+   for (int arg_index = 1; arg_index < arg_count; ++arg_index)
+      if (string(arg_values[arg_index]) == "--estimate")
+         estimate_only = true;
     
+   thread_pool_t thread_pool;
+
    for (int arg_index = 1; arg_index < arg_count; ++arg_index)
    {
+      if (string(arg_values[arg_index]).starts_with("--"))
+         continue;
+
       try
       {
          const path filename(arg_values[arg_index]);
          cout << "Solving puzzle: " << filename.filename() << endl;
 
-         ifstream puzzle_stream(filename);
+         const vector<puzzle_t> puzzles = load_puzzles(filename);
 
          path solution_filename(filename);
          solution_filename.replace_extension("solutions.txt");
-         ofstream solution_stream(solution_filename);
+         ofstream solution_stream;
+         if (!estimate_only)
+            solution_stream.open(solution_filename);
 
-         while (puzzle_stream) {
-            puzzle_t puzzle;
-            puzzle_stream >> puzzle;
-            
+         for (const puzzle_t& puzzle : puzzles) {
             cout << "Puzzle: " << puzzle << endl;
 
+            if (estimate_only) {
+               const estimate_t estimate = estimator_t<puzzle_t, dak::six_eight::solution_t>::estimate(puzzle, {});
+               cout << "estimated nodes: " << size_t(estimate.nodes_count) << endl;
+               cout << "estimated time: " << size_t(estimate.milliseconds) << " ms" << endl;
+               continue;
+            }
+
             string elapsed_time;
             stopwatch_t stopwatch(elapsed_time);
 
-            stream_progress_t progress(cout);
-            const auto solutions = solver_t<puzzle_t, solution_t>::solve(puzzle, {}, progress);
+            stream_search_progress_t progress(cout);
+            const auto solutions = solver_t<puzzle_t, dak::six_eight::solution_t>::solve(puzzle, {}, progress, thread_pool);
 
             stopwatch.stop();
 
             cout << "\n";
             cout << "time: " << elapsed_time << endl;
             cout << "solutions: " << solutions.size() << endl;
+            print_counters(progress.counters());
 
-            for (const auto& solution : solutions) {
-               cout << solution << endl;
-               solution_stream << solution << endl;
-            }
+            write_solutions(cout, solutions);
+            write_solutions(solution_stream, solutions);
          }
       }
       catch (exception& ex)
@@ -0,0 +1,76 @@
+#include "dak/six_eight/parse.h"
+#include "dak/six_eight_tests/helpers.h"
+
+#include "CppUnitTest.h"
+
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::six_eight;
+
+namespace dak::six_eight::tests
+{
+   TEST_CLASS(parse_tests)
+   {
+   public:
+
+      TEST_METHOD(parse_tile_with_rotation)
+      {
+         Assert::AreEqual(tile_t('a').rotate(3), parse_tile("a rotated 3 times "));
+      }
+
+      TEST_METHOD(parse_puzzles_list)
+      {
+         const auto puzzles = parse_puzzles("8 m q Q s d 3 f\r\na b l d f g h i\n\n");
+
+         Assert::AreEqual<size_t>(2, puzzles.size());
+         Assert::AreEqual<size_t>(8, puzzles[1].initial_tiles().size());
+         Assert::AreEqual(tile_t('Q'), puzzles[0].initial_tiles()[3]);
+         Assert::AreEqual(tile_t('i'), puzzles[1].initial_tiles()[7]);
+      }
+
+      TEST_METHOD(parse_puzzles_error_position)
+      {
+         try
+         {
+            parse_puzzles("8 m q Q s d 3 f\na b l d P g h i\n");
+            Assert::Fail();
+         }
+         catch (const parse_error_t& ex)
+         {
+            Assert::AreEqual<size_t>(2, ex.line());
+            Assert::AreEqual<size_t>(9, ex.column());
+         }
+
+         try
+         {
+            parse_puzzles("8 m q Q s d 3\n");
+            Assert::Fail();
+         }
+         catch (const parse_error_t& ex)
+         {
+            Assert::AreEqual<size_t>(2, ex.line());
+            Assert::AreEqual<size_t>(1, ex.column());
+         }
+      }
+
+      TEST_METHOD(parse_solutions_round_trip)
+      {
+         solution_t sol;
+         sol.add_tile(tile_t('a'), position_t(0, 0));
+         sol.add_tile(tile_t('b').rotate(1), position_t(3, 0));
+
+         solution_t other;
+         other.add_tile(tile_t('c'), position_t(0, 0));
+
+         all_solutions_t solutions;
+         solutions.insert(sol);
+         solutions.insert(other);
+
+         std::ostringstream stream;
+         stream << solutions;
+
+         Assert::IsTrue(solutions == parse_solutions(stream.str()));
+      }
+   };
+}
@@ -232,6 +232,32 @@ namespace dak::six_eight::tests
 
          Assert::AreEqual(false, position_t(0, 0).relative(position_t(-1, 1)).has_value());
 
+         Assert::AreEqual(false, position_t(0, 0).relative(position_t(0, 0)).has_value());
+         Assert::AreEqual(false, position_t(0, 0).relative(position_t(2, 0)).has_value());
+
+         for (int x = -6; x < 6; ++x)
+            for (int y = -6; y < 6; ++y)
+               for (const direction_t dir : directions)
+                  Assert::AreEqual(dir, position_t(x, y).relative(position_t(x, y).move(dir)).value());
+      }
+
+      TEST_METHOD(position_key)
+      {
+         for (int x = -20; x < 20; ++x)
+         {
+            for (int y = -20; y < 20; ++y)
+            {
+               const position_t pos(x, y);
+               Assert::AreEqual(pos, position_t::from_key(pos.key()));
+
+               for (const direction_t dir : directions)
+                  Assert::AreEqual(pos.move(dir).key(), pos.neighbour_key(dir));
+
+               // Keys are ordered like the positions.
+               const position_t other(y, x);
+               Assert::AreEqual(pos < other, pos.key() < other.key());
+            }
+         }
       }
 
    };
@@ -0,0 +1,485 @@
+#include "dak/tantrix/tantrix.h"
+#include "dak/tantrix/parse.h"
+#include "dak/six_eight/six_eight.h"
+#include "dak/six_eight/parse.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/search/thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(__linux__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace dak::search;
+
+#if !defined(DAK_SOURCE_DIR)
+#define DAK_SOURCE_DIR "."
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+//
+// End-to-end benchmark of the solvers.
+//
+// Solve every tantrix puzzle file and every six-eight puzzle, record the
+// time, speed, peak memory and number of solutions of each, check the
+// number of solutions against the golden counts and compare the time and
+// speed against the results of a previous run.
+
+using clock_type = chrono::steady_clock;
+using path = filesystem::path;
+
+// Time regressions are not flagged for shorter runs, they are too noisy.
+constexpr double min_regression_seconds = 0.1;
+
+// Result of solving a puzzle.
+struct bench_result_t
+{
+   string            name;
+   string            status;
+   size_t            solutions_count = 0;
+   optional<size_t>  golden_count;
+   double            seconds = 0.;
+   uint64_t          nodes_count = 0;
+   double            nodes_per_second = 0.;
+   uint64_t          peak_rss_kb = 0;
+   bool              is_regression = false;
+};
+
+// A puzzle to solve, identified by its name.
+struct bench_puzzle_t
+{
+   string                                    name;
+   shared_ptr<dak::tantrix::puzzle_t>        tantrix_puzzle;
+   optional<dak::six_eight::puzzle_t>        six_eight_puzzle;
+};
+
+// Error thrown by the progress to stop a search that takes too long.
+struct time_limit_error_t : runtime_error
+{
+   time_limit_error_t() : runtime_error("time limit reached") {}
+};
+
+// Progress that stops the search after the time limit, if there is one.
+struct bench_progress_t : search_progress_t
+{
+   bench_progress_t(chrono::seconds a_time_limit)
+   : search_progress_t(100000), my_time_limit(a_time_limit), my_start(clock_type::now())
+   {
+   }
+
+   void update_progress(size_t /*a_total_count_so_far*/) override
+   {
+      if (my_time_limit.count() > 0 && clock_type::now() - my_start > my_time_limit)
+         throw time_limit_error_t();
+   }
+
+private:
+   chrono::seconds         my_time_limit;
+   clock_type::time_point  my_start;
+};
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Peak memory.
+//
+// On Linux, the peak resident memory is reset before each puzzle, so it
+// is the peak of that puzzle. Elsewhere it is the peak of the process
+// so far, or zero when unavailable.
+
+static void reset_peak_rss()
+{
+#if defined(__linux__)
+   ofstream clear_refs("/proc/self/clear_refs");
+   clear_refs << "5";
+#endif
+}
+
+static uint64_t peak_rss_kb()
+{
+#if defined(__linux__)
+   ifstream status("/proc/self/status");
+   string line;
+   while (getline(status, line))
+      if (line.starts_with("VmHWM:"))
+         return stoull(line.substr(6));
+   return 0;
+#elif defined(__unix__) || defined(__APPLE__)
+   rusage usage = {};
+   getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+   return uint64_t(usage.ru_maxrss) / 1024;
+#else
+   return uint64_t(usage.ru_maxrss);
+#endif
+#else
+   return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Puzzles.
+
+static vector<bench_puzzle_t> load_bench_puzzles(const path& a_tantrix_folder, const path& a_six_eight_filename)
+{
+   vector<bench_puzzle_t> puzzles;
+
+   vector<path> filenames;
+   for (const auto& entry : filesystem::directory_iterator(a_tantrix_folder))
+      if (entry.is_regular_file() && entry.path().extension() == ".txt")
+         filenames.push_back(entry.path());
+   sort(filenames.begin(), filenames.end());
+
+   for (const path& filename : filenames)
+      puzzles.push_back(bench_puzzle_t{ "tantrix/" + filename.filename().string(), dak::tantrix::load_puzzle(filename), {} });
+
+   const vector<dak::six_eight::puzzle_t> six_eight_puzzles = dak::six_eight::load_puzzles(a_six_eight_filename);
+   for (size_t i = 0; i < six_eight_puzzles.size(); ++i)
+      puzzles.push_back(bench_puzzle_t{ "six_eight/" + a_six_eight_filename.filename().string() + "#" + to_string(i + 1), nullptr, six_eight_puzzles[i] });
+
+   return puzzles;
+}
+
+// Solve the puzzle and return the number of solutions.
+static size_t solve_bench_puzzle(const bench_puzzle_t& a_puzzle, bench_progress_t& a_progress, thread_pool_t& a_thread_pool)
+{
+   using namespace dak;
+
+   if (auto tri = dynamic_pointer_cast<tantrix::triangle_puzzle_t>(a_puzzle.tantrix_puzzle))
+      return solver_t<tantrix::triangle_puzzle_t, tantrix::solution_t>::solve(*tri, tantrix::solution_t(*tri), a_progress, a_thread_pool).size();
+
+   if (auto mask = dynamic_pointer_cast<tantrix::mask_puzzle_t>(a_puzzle.tantrix_puzzle))
+      return solver_t<tantrix::mask_puzzle_t, tantrix::solution_t>::solve(*mask, tantrix::solution_t(*mask), a_progress, a_thread_pool).size();
+
+   if (auto shape = dynamic_pointer_cast<tantrix::any_shape_puzzle_t>(a_puzzle.tantrix_puzzle))
+      return solver_t<tantrix::any_shape_puzzle_t, tantrix::solution_t>::solve(*shape, tantrix::solution_t(*shape), a_progress, a_thread_pool).size();
+
+   if (a_puzzle.six_eight_puzzle)
+      return solver_t<six_eight::puzzle_t, six_eight::solution_t>::solve(*a_puzzle.six_eight_puzzle, {}, a_progress, a_thread_pool).size();
+
+   throw runtime_error("invalid puzzle");
+}
+
+static bench_result_t run_bench_puzzle(const bench_puzzle_t& a_puzzle, const map<string, size_t>& some_golden_counts, chrono::seconds a_time_limit, thread_pool_t& a_thread_pool)
+{
+   bench_result_t result;
+   result.name = a_puzzle.name;
+   if (auto pos = some_golden_counts.find(a_puzzle.name); pos != some_golden_counts.end())
+      result.golden_count = pos->second;
+
+   reset_peak_rss();
+   bench_progress_t progress(a_time_limit);
+   const auto start = clock_type::now();
+
+   try
+   {
+      result.solutions_count = solve_bench_puzzle(a_puzzle, progress, a_thread_pool);
+      if (!result.golden_count)
+         result.status = "unchecked";
+      else if (result.golden_count.value() == result.solutions_count)
+         result.status = "ok";
+      else
+         result.status = "mismatch";
+   }
+   catch (const time_limit_error_t&)
+   {
+      result.status = "timeout";
+   }
+   catch (const exception&)
+   {
+      result.status = "error";
+   }
+
+   result.seconds = chrono::duration<double>(clock_type::now() - start).count();
+   result.nodes_count = progress.counters().nodes_count();
+   result.nodes_per_second = progress.counters().nodes_per_second();
+   result.peak_rss_kb = peak_rss_kb();
+
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Golden counts: one "name = count" line per puzzle, with '#' comments.
+
+static map<string, size_t> load_golden_counts(const path& a_filename)
+{
+   map<string, size_t> counts;
+
+   ifstream stream(a_filename);
+   string line;
+   while (getline(stream, line))
+   {
+      if (line.empty() || line[0] == '#')
+         continue;
+      const size_t equal_pos = line.rfind(" = ");
+      if (equal_pos == string::npos)
+         continue;
+      counts[line.substr(0, equal_pos)] = stoull(line.substr(equal_pos + 3));
+   }
+
+   return counts;
+}
+
+static void save_golden_counts(const path& a_filename, const vector<bench_result_t>& some_results)
+{
+   ofstream stream(a_filename);
+   stream << "# Expected number of solutions of each puzzle of the solver benchmark.\n";
+   for (const bench_result_t& result : some_results)
+      if (result.status != "timeout" && result.status != "error")
+         stream << result.name << " = " << result.solutions_count << "\n";
+}
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Results, as CSV or as JSON with one puzzle per line.
+
+static void write_csv(ostream& a_stream, const vector<bench_result_t>& some_results)
+{
+   a_stream << "name,status,solutions,golden,seconds,nodes,nodes_per_second,peak_rss_kb,regression\n";
+   for (const bench_result_t& result : some_results)
+   {
+      a_stream << '"' << result.name << "\"," << result.status << "," << result.solutions_count << ",";
+      if (result.golden_count)
+         a_stream << result.golden_count.value();
+      a_stream << "," << result.seconds << "," << result.nodes_count << "," << uint64_t(result.nodes_per_second)
+               << "," << result.peak_rss_kb << "," << (result.is_regression ? "yes" : "no") << "\n";
+   }
+}
+
+static void write_json(ostream& a_stream, const vector<bench_result_t>& some_results)
+{
+   a_stream << "[";
+   for (size_t i = 0; i < some_results.size(); ++i)
+   {
+      const bench_result_t& result = some_results[i];
+      a_stream << (i ? ",\n" : "\n")
+               << "  { \"name\": \"" << result.name << "\", \"status\": \"" << result.status
+               << "\", \"solutions\": " << result.solutions_count << ", \"golden\": ";
+      if (result.golden_count)
+         a_stream << result.golden_count.value();
+      else
+         a_stream << "null";
+      a_stream << ", \"seconds\": " << result.seconds << ", \"nodes\": " << result.nodes_count
+               << ", \"nodes_per_second\": " << uint64_t(result.nodes_per_second) << ", \"peak_rss_kb\": " << result.peak_rss_kb
+               << ", \"regression\": " << (result.is_regression ? "true" : "false") << " }";
+   }
+   a_stream << "\n]\n";
+}
+
+static void save_results(const path& a_filename, const vector<bench_result_t>& some_results, bool as_csv)
+{
+   ofstream stream(a_filename);
+   if (as_csv)
+      write_csv(stream, some_results);
+   else
+      write_json(stream, some_results);
+}
+
+// Read the results of a previous run, written as CSV or JSON by this program.
+static map<string, bench_result_t> load_baseline(const path& a_filename)
+{
+   map<string, bench_result_t> results;
+
+   ifstream stream(a_filename);
+   string line;
+   if (a_filename.extension() == ".csv")
+   {
+      getline(stream, line);
+      while (getline(stream, line))
+      {
+         const size_t name_end = line.find("\",");
+         if (line.empty() || line[0] != '"' || name_end == string::npos)
+            continue;
+
+         bench_result_t result;
+         result.name = line.substr(1, name_end - 1);
+
+         vector<string> fields;
+         istringstream field_stream(line.substr(name_end + 2));
+         string field;
+         while (getline(field_stream, field, ','))
+            fields.push_back(field);
+         if (fields.size() < 7)
+            continue;
+
+         result.status = fields[0];
+         result.solutions_count = stoull(fields[1]);
+         result.seconds = stod(fields[3]);
+         result.nodes_count = stoull(fields[4]);
+         result.nodes_per_second = stod(fields[5]);
+         results[result.name] = result;
+      }
+   }
+   else
+   {
+      const auto find_value = [](const string& a_line, const string& a_key) -> string
+      {
+         const string key = "\"" + a_key + "\": ";
+         size_t pos = a_line.find(key);
+         if (pos == string::npos)
+            return string();
+         pos += key.size();
+         if (a_line[pos] == '"')
+            return a_line.substr(pos + 1, a_line.find('"', pos + 1) - pos - 1);
+         return a_line.substr(pos, a_line.find_first_of(", }", pos) - pos);
+      };
+
+      while (getline(stream, line))
+      {
+         bench_result_t result;
+         result.name = find_value(line, "name");
+         if (result.name.empty())
+            continue;
+         result.status = find_value(line, "status");
+         result.solutions_count = stoull(find_value(line, "solutions"));
+         result.seconds = stod(find_value(line, "seconds"));
+         result.nodes_count = stoull(find_value(line, "nodes"));
+         result.nodes_per_second = stod(find_value(line, "nodes_per_second"));
+         results[result.name] = result;
+      }
+   }
+
+   return results;
+}
+
+// Flag the results that are slower than the baseline by more than the threshold.
+static void flag_regressions(vector<bench_result_t>& some_results, const map<string, bench_result_t>& a_baseline, double a_threshold_percent)
+{
+   const double threshold = a_threshold_percent / 100.;
+   for (bench_result_t& result : some_results)
+   {
+      const auto pos = a_baseline.find(result.name);
+      if (pos == a_baseline.end())
+         continue;
+
+      const bench_result_t& previous = pos->second;
+      if (previous.status == "timeout" || previous.status == "error")
+         continue;
+
+      if (result.status == "timeout")
+      {
+         result.is_regression = true;
+         continue;
+      }
+
+      if (previous.seconds >= min_regression_seconds && result.seconds > previous.seconds * (1. + threshold))
+         result.is_regression = true;
+      if (previous.seconds >= min_regression_seconds && result.nodes_per_second < previous.nodes_per_second * (1. - threshold))
+         result.is_regression = true;
+   }
+}
+
+int main(int arg_count, char** arg_values)
+{
+   path tantrix_folder = path(DAK_SOURCE_DIR) / "tantrix_solver" / "puzzles";
+   path six_eight_filename = path(DAK_SOURCE_DIR) / "six_eight_solver" / "puzzles" / "6x8 puzzles.txt";
+   path golden_filename = path(DAK_SOURCE_DIR) / "solver_bench" / "golden.txt";
+   path write_golden_filename;
+   path csv_filename;
+   path json_filename;
+   path baseline_filename;
+   double threshold_percent = 10.;
+   chrono::seconds time_limit(0);
+   vector<string> filters;
+
+   for (int arg_index = 1; arg_index < arg_count; ++arg_index)
+   {
+      const string arg(arg_values[arg_index]);
+      const bool has_value = arg_index + 1 < arg_count;
+      if (arg == "--tantrix-puzzles" && has_value)
+         tantrix_folder = arg_values[++arg_index];
+      else if (arg == "--six-eight-puzzles" && has_value)
+         six_eight_filename = arg_values[++arg_index];
+      else if (arg == "--golden" && has_value)
+         golden_filename = arg_values[++arg_index];
+      else if (arg == "--write-golden" && has_value)
+         write_golden_filename = arg_values[++arg_index];
+      else if (arg == "--csv" && has_value)
+         csv_filename = arg_values[++arg_index];
+      else if (arg == "--json" && has_value)
+         json_filename = arg_values[++arg_index];
+      else if (arg == "--baseline" && has_value)
+         baseline_filename = arg_values[++arg_index];
+      else if (arg == "--threshold" && has_value)
+         threshold_percent = stod(arg_values[++arg_index]);
+      else if (arg == "--time-limit" && has_value)
+         time_limit = chrono::seconds(stoul(arg_values[++arg_index]));
+      else
+         filters.emplace_back(arg);
+   }
+
+   try
+   {
+      const map<string, size_t> golden_counts = load_golden_counts(golden_filename);
+
+      // Only solve the puzzles whose name contains one of the filters.
+      vector<bench_puzzle_t> puzzles = load_bench_puzzles(tantrix_folder, six_eight_filename);
+      erase_if(puzzles, [&filters](const bench_puzzle_t& a_puzzle)
+      {
+         return !filters.empty() && none_of(filters.begin(), filters.end(), [&a_puzzle](const string& a_filter)
+         {
+            return a_puzzle.name.find(a_filter) != string::npos;
+         });
+      });
+
+      thread_pool_t thread_pool;
+      vector<bench_result_t> results;
+      for (const bench_puzzle_t& puzzle : puzzles)
+      {
+         cout << puzzle.name << ": " << flush;
+         results.push_back(run_bench_puzzle(puzzle, golden_counts, time_limit, thread_pool));
+         const bench_result_t& result = results.back();
+         cout << result.status << ", " << result.solutions_count << " solutions";
+         if (result.golden_count && result.status == "mismatch")
+            cout << " (expected " << result.golden_count.value() << ")";
+         cout << ", " << result.seconds << " s, " << uint64_t(result.nodes_per_second) << " nodes/s, "
+              << result.peak_rss_kb << " KiB" << endl;
+      }
+
+      if (!baseline_filename.empty())
+         flag_regressions(results, load_baseline(baseline_filename), threshold_percent);
+
+      if (!csv_filename.empty())
+         save_results(csv_filename, results, true);
+      if (!json_filename.empty())
+         save_results(json_filename, results, false);
+      if (!write_golden_filename.empty())
+         save_golden_counts(write_golden_filename, results);
+
+      // Report the problems and fail if there are any.
+      size_t failures_count = 0;
+      for (const bench_result_t& result : results)
+      {
+         if (result.status == "mismatch" || result.status == "error")
+         {
+            cout << "FAILED: " << result.name << ": " << result.status << endl;
+            ++failures_count;
+         }
+         if (result.is_regression)
+         {
+            cout << "REGRESSION: " << result.name << " is more than " << threshold_percent << "% slower than the baseline" << endl;
+            ++failures_count;
+         }
+      }
+
+      return failures_count ? 1 : 0;
+   }
+   catch (const exception& ex)
+   {
+      cout << "Error: " << ex.what() << endl;
+      return 2;
+   }
+}
@@ -7,6 +7,10 @@
 
 #include "dak/tantrix/puzzle.h"
 #include "dak/tantrix/solution.h"
+#include "dak/tantrix/transposition_table.h"
+#include "dak/search/generator.h"
+
+#include <memory>
 
 
 namespace dak::tantrix
@@ -31,14 +35,57 @@ namespace dak::tantrix
       std::vector<sub_problem_t> create_initial_sub_problems() const;
 
       // Create sub-puzzles from a given sub-puzzle that has its tile placed.
-      std::vector<sub_problem_t> create_sub_problems(
+      // The sub-puzzles are allocated from the given memory resource.
+      sub_problems_t create_sub_problems(
          const sub_problem_t& a_current_sub_problem,
-         const solution_t& a_partial_solution) const;
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
 
       // Get the list of potential position for the tile-to-be-placed of the given sub-puzzle.
-      std::vector<solution_t::part_t> get_sub_problem_potential_parts(
+      // The parts are allocated from the given memory resource.
+      solution_t::parts_t get_sub_problem_potential_parts(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
+
+      // Lazy solver interaction.
+      //
+      // Same as above, but the sub-puzzles and parts are produced one at a time.
+      // Each one is only valid until the next one is produced.
+
+      // Generate sub-puzzles from a given sub-puzzle that has its tile placed.
+      search::generator_t<sub_problem_t> generate_sub_problems(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
+
+      // Generate the potential position for the tile-to-be-placed of the given sub-puzzle.
+      search::generator_t<solution_t::part_t> generate_sub_problem_potential_parts(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
+
+      // Transposition table.
+
+      // Skip partial solutions already reached by placing the same tiles in a different
+      // order, remembering them in a table using at most the given number of bytes.
+      // A zero budget disables the table. The table is cleared when a search
+      // creates the initial sub-puzzles. Copies of the puzzle share the table.
+      void use_transposition_table(size_t a_memory_budget);
+
+      // The transposition table, if any. Gives access to its statistics.
+      const std::shared_ptr<transposition_table_t>& transposition_table() const { return my_transpositions; }
+
+      // A copy of the puzzle that does not use the transposition table,
+      // for explorations that must not record the partial solutions they visit.
+      any_shape_puzzle_t without_transposition_table() const;
+
+   private:
+      std::uint64_t transposition_key(
          const sub_problem_t& a_current_sub_problem,
          const solution_t& a_partial_solution) const;
+
+      std::shared_ptr<transposition_table_t> my_transpositions;
    };
 
 }
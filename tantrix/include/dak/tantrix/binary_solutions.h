@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_BINARY_SOLUTIONS_H
+#define DAK_TANTRIX_BINARY_SOLUTIONS_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/solution.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Compact binary format for solutions.
+   //
+   // The file starts with a fixed header, followed by one fixed-size record
+   // per solution. All solutions of a file have the same number of tiles.
+   // Each tile takes three bytes, little-endian: the tile number in the low
+   // six bits, then three bits of rotation, then six bits for each of the
+   // x and y coordinates, offset by 32.
+   //
+   // Like the text format, only the tiles and their placement are kept.
+
+   struct binary_solutions_header_t
+   {
+      static constexpr char           expected_magic[4] = { 'T', 'X', 'S', 'B' };
+      static constexpr std::uint16_t  current_version = 1;
+
+      char           magic[4] = { 'T', 'X', 'S', 'B' };
+      std::uint16_t  version = current_version;
+      std::uint16_t  tiles_count = 0;
+      std::uint32_t  solutions_count = 0;
+      std::uint32_t  reserved = 0;
+   };
+
+   static_assert(sizeof(binary_solutions_header_t) == 16);
+
+   // Size of a tile in a binary solution record.
+   constexpr size_t binary_part_size = 3;
+
+   // Write the solutions in binary form.
+   // Throws if the solutions do not all have the same number of tiles
+   // or if a position is too far from the origin to be encoded.
+   void write_binary_solutions(std::ostream& a_stream, const all_solutions_t& some_solutions);
+
+   // Check if a file starts with the header of binary solutions.
+   bool is_binary_solutions_file(const std::filesystem::path& a_path);
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Binary solutions file mapped in memory.
+   //
+   // The records are decoded directly from the mapped file when accessed,
+   // nothing is read or copied when the file is opened.
+
+   struct mapped_solutions_t
+   {
+      // Map the file. Throws if the file cannot be mapped or is not valid.
+      mapped_solutions_t(const std::filesystem::path& a_path);
+      ~mapped_solutions_t();
+
+      mapped_solutions_t(const mapped_solutions_t&) = delete;
+      mapped_solutions_t& operator=(const mapped_solutions_t&) = delete;
+
+      // Number of solutions in the file and number of tiles in each.
+      size_t size() const { return my_header.solutions_count; }
+      size_t tiles_count() const { return my_header.tiles_count; }
+
+      // Decode one tile of one solution.
+      solution_t::part_t part(size_t a_solution_index, size_t a_tile_index) const;
+
+      // Decode a complete solution.
+      solution_t solution(size_t a_solution_index) const;
+
+      // Decode all solutions.
+      all_solutions_t all_solutions() const;
+
+   private:
+      const std::byte* record(size_t a_solution_index) const;
+      void unmap();
+
+      binary_solutions_header_t  my_header;
+      const std::byte*           my_data = nullptr;
+      size_t                     my_size = 0;
+      std::intptr_t              my_file = -1;
+      void*                      my_mapping = nullptr;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Solutions files in either format.
+
+   // Load the solutions of a file, detecting its format.
+   all_solutions_t load_solutions(const std::filesystem::path& a_path);
+
+   // Save solutions in text or binary format.
+   void save_solutions(const std::filesystem::path& a_path, const all_solutions_t& some_solutions, bool is_binary);
+
+   // Convert a text solutions file to a binary one.
+   void convert_text_to_binary_solutions(const std::filesystem::path& a_text_path, const std::filesystem::path& a_binary_path);
+
+   // Convert a binary solutions file to a text one.
+   void convert_binary_to_text_solutions(const std::filesystem::path& a_binary_path, const std::filesystem::path& a_text_path);
+}
+
+#endif /* DAK_TANTRIX_BINARY_SOLUTIONS_H */
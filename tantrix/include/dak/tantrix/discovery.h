@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_DISCOVERY_H
+#define DAK_TANTRIX_DISCOVERY_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/any_shape_puzzle.h"
+#include "dak/tantrix/color.h"
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Discovery puzzles: a single loop of one color through the tiles 1 to N.
+   //
+   // The family of puzzles is swept for a range of N. The tiles having each
+   // color are kept as a mask, so the colors a loop can have for a given N
+   // are the ones whose mask contains all the tiles 1 to N.
+
+   struct discovery_puzzle_t
+   {
+      size_t   tiles_count = 0;
+      color_t  color;
+
+      auto operator<=>(const discovery_puzzle_t& an_other) const = default;
+   };
+
+   // The Discovery puzzles from the minimum to the maximum number of tiles,
+   // by number of tiles then by color. A solution holds at most 32 tiles.
+   std::vector<discovery_puzzle_t> discovery_puzzles(size_t a_min_tiles_count, size_t a_max_tiles_count);
+
+   // Create the puzzle to solve for a Discovery puzzle.
+   std::shared_ptr<any_shape_puzzle_t> create_discovery_puzzle(const discovery_puzzle_t& a_discovery);
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Result of solving a Discovery puzzle.
+   //
+   // The results of a sweep are written as CSV lines, one line per puzzle as
+   // soon as it is solved, so an interrupted sweep can be resumed by skipping
+   // the puzzles already in its results. A later line for the same puzzle
+   // replaces an earlier one.
+
+   struct discovery_result_t
+   {
+      discovery_puzzle_t   puzzle;
+      std::string          status;
+      size_t               solutions_count = 0;
+      std::uint64_t        nodes_count = 0;
+      double               seconds = 0.;
+   };
+
+   using discovery_results_t = std::map<discovery_puzzle_t, discovery_result_t>;
+
+   // Write the header line of the results.
+   void write_discovery_header(std::ostream& a_stream);
+
+   // Write the line of a result.
+   void write_discovery_result(std::ostream& a_stream, const discovery_result_t& a_result);
+
+   // Read the results written in a stream, skipping the header and invalid lines.
+   discovery_results_t read_discovery_results(std::istream& a_stream);
+}
+
+#endif /* DAK_TANTRIX_DISCOVERY_H */
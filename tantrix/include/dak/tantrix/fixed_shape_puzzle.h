@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_FIXED_SHAPE_PUZZLE_H
+#define DAK_TANTRIX_FIXED_SHAPE_PUZZLE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/puzzle.h"
+#include "dak/tantrix/solution.h"
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Puzzle with tiles placed in a fixed set of slots.
+   //
+   // The tiles are placed in a fixed order of slots, so the n-th placed
+   // tile is always in the n-th slot. The derived puzzles give the position
+   // of each slot, in order. The earlier slots next to each slot, and their
+   // direction, are found once. The rotations of a tile are then only checked
+   // against those neighbours, and the parts given to the solver are already
+   // compatible. Positions outside the slots are never tried.
+   //
+   // After each placement, the lines of each color are checked to still be
+   // possible to complete: line ends on the border of the shape can never
+   // be joined, the remaining tiles can only join so many line ends, and no
+   // loop can close before all the tiles of its color are placed.
+   //
+   // Every slot after the first must be next to an earlier slot.
+
+   struct fixed_shape_puzzle_t : puzzle_t
+   {
+      // The potential parts only fit the partial solution, the solver does not need to check them.
+      static constexpr bool parts_are_compatible = true;
+
+      // Create a puzzle.
+      fixed_shape_puzzle_t() = default;
+      fixed_shape_puzzle_t(const std::vector<tile_t>& some_tiles,
+                           const std::vector<color_t>& some_line_colors,
+                           bool must_be_loops,
+                           const maybe_size_t& a_holes_count = {})
+         : puzzle_t(some_tiles, some_line_colors, must_be_loops, a_holes_count) {}
+
+      // Solver interaction.
+
+      // Create the initial list of sub-puzzles to solve.
+      std::vector<sub_problem_t> create_initial_sub_problems() const;
+
+      // Create sub-puzzles from a given sub-puzzle that has its tile placed.
+      // The sub-puzzles are allocated from the given memory resource.
+      sub_problems_t create_sub_problems(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
+
+      // Get the list of potential position for the tile-to-be-placed of the given sub-puzzle.
+      // The parts are allocated from the given memory resource.
+      solution_t::parts_t get_sub_problem_potential_parts(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
+
+      // The position of each slot, in the order they are filled.
+      const std::vector<position_t>& slot_positions() const { return my_slot_positions; }
+
+   protected:
+      // Fill the slots in the given order of positions.
+      void use_positions(std::vector<position_t>&& some_positions);
+
+   private:
+      // Earlier slots next to a slot, with the direction from the slot to each of them.
+      // The last one is the most recently filled.
+      struct slot_neighbours_t
+      {
+         std::uint8_t   slots[6] = {};
+         std::uint8_t   directions[6] = {};
+         std::uint8_t   count = 0;
+      };
+
+      // Slot next to a slot in each direction, or -1 outside the shape.
+      struct slot_adjacents_t
+      {
+         std::int8_t    slots[6] = { -1, -1, -1, -1, -1, -1 };
+      };
+
+      // Check if the lines of the given color can still be completed by the remaining tiles.
+      bool can_complete_line(
+         const color_t& a_color,
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution) const;
+
+      // Check if the last placed tile closed a loop of the given color.
+      bool has_closed_loop(
+         const color_t& a_color,
+         const solution_t& a_partial_solution) const;
+
+      std::vector<position_t>          my_slot_positions;
+      std::vector<slot_neighbours_t>   my_slot_neighbours;
+      std::vector<slot_adjacents_t>    my_slot_adjacents;
+   };
+}
+
+#endif /* DAK_TANTRIX_FIXED_SHAPE_PUZZLE_H */
@@ -0,0 +1,32 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_FORMAT_H
+#define DAK_TANTRIX_FORMAT_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/solution.h"
+
+#include "dak/search/text_writer.h"
+
+#include <iostream>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Write solutions as text, in the format read by parse_solutions.
+   //
+   // The text is formatted in a large buffer, which is much faster than
+   // formatting each tile through the stream.
+
+   // Write a solution: its validity, then one placed tile per line.
+   void write_solution(search::text_writer_t& a_writer, const solution_t& a_solution);
+
+   // Write solutions, each followed by a blank line.
+   void write_solutions(search::text_writer_t& a_writer, const all_solutions_t& some_solutions);
+   void write_solutions(std::ostream& a_stream, const all_solutions_t& some_solutions);
+}
+
+#endif /* DAK_TANTRIX_FORMAT_H */
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_MASK_PUZZLE_H
+#define DAK_TANTRIX_MASK_PUZZLE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/fixed_shape_puzzle.h"
+
+#include <string>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Puzzle with tiles placed in the cells of a mask, to give it any fixed
+   // outline, like an hexagon or a diamond.
+   //
+   // The mask is a list of rows, where X is a cell and . is not. The cell
+   // at column x of row y is at position x/y, so each row is shifted half
+   // a cell to the right of the row above. For example, an hexagon of seven
+   // cells is:
+   //
+   //    .XX
+   //    XXX
+   //    XX.
+   //
+   // The cells are filled starting from the one with the fewest neighbours,
+   // then each time the cell with the most filled neighbours. Each tile is
+   // then constrained by as many neighbours as possible.
+
+   struct mask_puzzle_t : fixed_shape_puzzle_t
+   {
+      using mask_t = std::vector<std::string>;
+
+      // Create a puzzle. The mask must have as many cells as there are tiles
+      // and its cells must all be connected.
+      mask_puzzle_t() = default;
+      mask_puzzle_t(const std::vector<tile_t>& some_tiles,
+                    const std::vector<color_t>& some_line_colors,
+                    bool must_be_loops,
+                    const mask_t& a_mask,
+                    const maybe_size_t& a_holes_count = {});
+
+      // The rows of the mask.
+      const mask_t& mask() const { return my_mask; }
+
+      // Count the cells of a mask.
+      static size_t count_cells(const mask_t& a_mask);
+
+   private:
+      // Order the cells of the mask so that each has the most filled neighbours.
+      static std::vector<position_t> ordered_positions(const mask_t& a_mask);
+
+      mask_t my_mask;
+   };
+}
+
+#endif /* DAK_TANTRIX_MASK_PUZZLE_H */
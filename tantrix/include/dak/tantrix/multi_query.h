@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_MULTI_QUERY_H
+#define DAK_TANTRIX_MULTI_QUERY_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/puzzle.h"
+#include "dak/tantrix/solution.h"
+
+#include <memory>
+#include <vector>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Solve with a single search several puzzles that only differ by their
+   // required number of holes.
+   //
+   // The number of holes is only checked on complete solutions, it never
+   // prunes the search. So the puzzle without the holes requirement finds
+   // all the solutions of the puzzles of its group, which are then split
+   // by counting the holes of each solution once.
+   //
+   // Puzzles with different lines, like the Crazy Tantrix puzzles, are not
+   // grouped: the lines guide where the tiles are placed, so they do not
+   // share their search.
+
+   struct query_group_t
+   {
+      // The puzzle to solve for the whole group.
+      std::shared_ptr<puzzle_t>  shared_puzzle;
+
+      // The index of each puzzle of the group in the given puzzles.
+      std::vector<size_t>        query_indices;
+   };
+
+   // Copy of the puzzle without its required number of holes.
+   std::shared_ptr<puzzle_t> without_holes_count(const puzzle_t& a_puzzle);
+
+   // Group the puzzles that can share their search, in the order of their first puzzle.
+   std::vector<query_group_t> group_queries(const std::vector<std::shared_ptr<puzzle_t>>& some_puzzles);
+
+   // Select the solutions of each puzzle of the group, in the order of its
+   // query indices, from the solutions of the shared puzzle.
+   std::vector<all_solutions_t> split_solutions(
+      const query_group_t& a_group,
+      const std::vector<std::shared_ptr<puzzle_t>>& some_puzzles,
+      const all_solutions_t& some_shared_solutions);
+}
+
+#endif /* DAK_TANTRIX_MULTI_QUERY_H */
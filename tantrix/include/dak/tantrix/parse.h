@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_PARSE_H
+#define DAK_TANTRIX_PARSE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/puzzle.h"
+#include "dak/tantrix/solution.h"
+
+#include "dak/search/text_parser.h"
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+
+namespace dak::tantrix
+{
+   using parse_error_t = search::parse_error_t;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Parse puzzles and solutions from text.
+   //
+   // The text is parsed in a single pass, without copying. Errors throw
+   // a parse_error_t giving the line and column of the error.
+
+   // Parse a tile written as its number followed by its six colors.
+   tile_t parse_tile(std::string_view a_text);
+
+   // Parse a puzzle description.
+   std::shared_ptr<puzzle_t> parse_puzzle(std::string_view a_text);
+
+   // Parse a single solution, with or without its validity line.
+   solution_t parse_solution(std::string_view a_text);
+
+   // Parse all solutions of a solutions text.
+   all_solutions_t parse_solutions(std::string_view a_text);
+
+   // Load a puzzle file.
+   std::shared_ptr<puzzle_t> load_puzzle(const std::filesystem::path& a_path);
+}
+
+#endif /* DAK_TANTRIX_PARSE_H */
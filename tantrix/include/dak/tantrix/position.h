@@ -6,6 +6,7 @@
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 
 #include <compare>
+#include <cstdint>
 #include <optional>
 
 #include "dak/tantrix/direction.h"
@@ -19,18 +20,30 @@ namespace dak::tantrix
 
    struct position_t
    {
+      // Packed position, ordered like the positions.
+      //
+      // Each coordinate is offset to be positive and stored in its own byte,
+      // so the key of a neighbour is a constant delta away in each direction.
+      using key_t = std::uint16_t;
+
       // Create a position.
       position_t() = default;
-      position_t(int a_x, int a_y) : my_x(std::int8_t(a_x)), my_y(std::int8_t(a_y)) {}
+      constexpr position_t(int a_x, int a_y) : my_x(std::int8_t(a_x)), my_y(std::int8_t(a_y)) {}
+
+      // Create a position from its packed key.
+      static constexpr position_t from_key(key_t a_key)
+      {
+         return position_t(int(a_key >> 8) - 128, int(a_key & 0xFF) - 128);
+      }
 
       // Move by an integer amount in the hexagonal grid.
-      position_t move(int delta_x, int delta_y) const
+      constexpr position_t move(int delta_x, int delta_y) const
       {
          return position_t(my_x + delta_x, my_y + delta_y);
       }
 
       // Move by an unit in the given direction.
-      position_t move(direction_t a_dir) const
+      constexpr position_t move(direction_t a_dir) const
       {
          return move(a_dir.delta_x(), a_dir.delta_y());
       }
@@ -52,28 +65,79 @@ namespace dak::tantrix
       }
 
       // Rotate in place by a multiple of sixth of a turn around the origin position.
-      position_t& rotate_in_place(int rotation);
+      constexpr position_t& rotate_in_place(int rotation)
+      {
+         const std::int8_t* factors = rotation_factors[(rotation % 6 + 6) % 6];
+         const int old_x = my_x;
+         const int old_y = my_y;
+         my_x = std::int8_t(old_x * factors[0] + old_y * factors[1]);
+         my_y = std::int8_t(old_x * factors[2] + old_y * factors[3]);
+         return *this;
+      }
 
       // Create a copy rotated by a multiple of sixth of a turn around the origin position.
-      position_t rotate(int rotation) const { return position_t(*this).rotate_in_place(rotation); }
+      constexpr position_t rotate(int rotation) const { return position_t(*this).rotate_in_place(rotation); }
 
       // Get the direction, if any, where a position is adjacent relative to this position.
-      std::optional<direction_t> relative(const position_t& a_pos) const
+      constexpr std::optional<direction_t> relative(const position_t& a_pos) const
+      {
+         const int dir = relative_index(a_pos);
+         if (dir < 0)
+            return std::optional<direction_t>();
+         return std::optional<direction_t>(direction_t(dir));
+      }
+
+      // Get the direction where a position is adjacent relative to this position
+      // as an integer, or -1 when it is not adjacent. Does not branch.
+      constexpr int relative_index(const position_t& a_pos) const
       {
-         for (const direction_t dir : directions)
-            if (move(dir.delta_x(), dir.delta_y()) == a_pos)
-               return std::optional<direction_t>(dir);
-         return std::optional<direction_t>();
+         const unsigned index_x = unsigned(a_pos.my_x - my_x + 1);
+         const unsigned index_y = unsigned(a_pos.my_y - my_y + 1);
+         const unsigned index = ((index_x | index_y) & ~3u) ? 15u : index_x * 4u + index_y;
+         return relative_directions[index];
       }
 
       // The position coordinates.
-      int x() const { return my_x; }
-      int y() const { return my_y; }
+      constexpr int x() const { return my_x; }
+      constexpr int y() const { return my_y; }
+
+      // The packed key of the position.
+      constexpr key_t key() const
+      {
+         return key_t((unsigned(my_x + 128) << 8) | unsigned(my_y + 128));
+      }
+
+      // The packed key of the neighbour in the given direction.
+      constexpr key_t neighbour_key(direction_t a_dir) const
+      {
+         return key_t(key() + a_dir.delta_key());
+      }
 
       // Position comparison.
       auto operator<=>(const position_t& an_other) const = default;
 
    private:
+      // Factors of x and y giving the rotated x and y, indexed by rotation.
+      static constexpr std::int8_t rotation_factors[6][4] =
+      {
+         {  1,  0,  0,  1 },
+         {  0, -1,  1,  1 },
+         { -1, -1,  1,  0 },
+         { -1,  0,  0, -1 },
+         {  0,  1, -1, -1 },
+         {  1,  1, -1,  0 },
+      };
+
+      // Direction of adjacent positions, indexed by their x and y delta plus one,
+      // four entries per x delta. Positions that are not adjacent have no direction.
+      static constexpr std::int8_t relative_directions[16] =
+      {
+         -1,  0,  5, -1,    // x - 1
+          1, -1,  4, -1,    // x
+          2,  3, -1, -1,    // x + 1
+         -1, -1, -1, -1,    // x + 2
+      };
+
       std::int8_t my_x = 0;
       std::int8_t my_y = 0;
    };
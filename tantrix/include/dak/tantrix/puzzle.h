@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory_resource>
 #include <optional>
 
 
@@ -26,11 +27,36 @@ namespace dak::tantrix
    struct puzzle_t : solver::problem_t
    {
       // Sub puzzle
+      //
+      // The other tiles can be allocated from a memory resource, usually
+      // the arena of the solver thread. Containers of sub-puzzles that use
+      // a memory resource pass it down to the sub-puzzles they contain.
 
       struct sub_problem_t
       {
-         tile_t               tile_to_place;
-         std::vector<tile_t>  other_tiles;
+         using allocator_type = std::pmr::polymorphic_allocator<>;
+
+         sub_problem_t() = default;
+         sub_problem_t(const sub_problem_t&) = default;
+         sub_problem_t(sub_problem_t&&) = default;
+         sub_problem_t& operator=(const sub_problem_t&) = default;
+         sub_problem_t& operator=(sub_problem_t&&) = default;
+
+         sub_problem_t(const allocator_type& an_allocator)
+         : other_tiles(an_allocator) {}
+
+         sub_problem_t(const sub_problem_t& an_other, const allocator_type& an_allocator)
+         : tile_to_place(an_other.tile_to_place)
+         , other_tiles(an_other.other_tiles, an_allocator)
+         , right_sub_puzzles_count(an_other.right_sub_puzzles_count) {}
+
+         sub_problem_t(sub_problem_t&& an_other, const allocator_type& an_allocator)
+         : tile_to_place(an_other.tile_to_place)
+         , other_tiles(std::move(an_other.other_tiles), an_allocator)
+         , right_sub_puzzles_count(an_other.right_sub_puzzles_count) {}
+
+         tile_t                     tile_to_place;
+         std::pmr::vector<tile_t>   other_tiles;
 
          // In any-shape puzzles, this counts down to when we flip from adding
          // tile to "right" side of the lines to adding tiles to the left side.
@@ -39,7 +65,7 @@ namespace dak::tantrix
          //
          // For triangle puzzles, the count differentiates between up and down
          // triangles.... although that should not matter?
-         int                  right_sub_puzzles_count = 0;
+         int                        right_sub_puzzles_count = 0;
 
          size_t count_tiles_of_color(color_t a_color) const
          {
@@ -50,6 +76,7 @@ namespace dak::tantrix
          }
       };
 
+      using sub_problems_t = std::pmr::vector<sub_problem_t>;
       using tiles_t = std::vector<tile_t>;
       using maybe_size_t = std::optional<size_t>;
 
@@ -69,6 +96,12 @@ namespace dak::tantrix
       // Verify if the solution satisfies the initial puzzle.
       virtual bool is_solution_valid(const solution_t& a_solution) const;
 
+      // Score used to rank partial solutions with as many tiles placed:
+      // the length of the longest line of the first color. The maximum
+      // is reached when all the tiles having that color are in the line.
+      std::int64_t partial_solution_score(const solution_t& a_partial_solution) const;
+      std::int64_t max_partial_solution_score() const;
+
       // The description of the puzzle.
 
       // The list of tiles to place.
@@ -10,7 +10,9 @@
 #include "dak/tantrix/tile.h"
 #include "dak/solver/solution.h"
 
+#include <memory_resource>
 #include <set>
+#include <span>
 #include <vector>
 #include <optional>
 
@@ -37,7 +39,14 @@ namespace dak::tantrix
 
 
       using tiles_by_pos_t = part_t[32];
-      using hole_t = std::vector<position_t>;
+
+      // Each placed tile has two ends of a line color.
+      static constexpr size_t max_line_ends = 2 * 32;
+
+      using parts_t = std::pmr::vector<part_t>;
+      using positions_t = std::pmr::vector<position_t>;
+      using hole_t = positions_t;
+      using holes_t = std::pmr::vector<hole_t>;
 
       // Create a new solution.
       solution_t(const puzzle_t& a_puzzle);
@@ -60,7 +69,10 @@ namespace dak::tantrix
       void add_part(const part_t& a_part);
 
       // Get the positions outside the solution where they touch a color.
-      std::vector<position_t> get_borders(const std::optional<color_t>& a_color = std::optional<color_t>()) const;
+      // The positions are allocated from the given memory resource.
+      positions_t get_borders(
+         const std::optional<color_t>& a_color = std::optional<color_t>(),
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
 
       // Create a copy of this solution rotated of a given amount (increment of sixth of a turn).
       solution_t rotate(int rotation) const;
@@ -78,6 +90,15 @@ namespace dak::tantrix
       // Check if a tile at a given position would be compatible with the solution.
       bool is_compatible(const part_t& a_part) const;
 
+      // Check which rotations of a tile at a given position would be compatible with the solution.
+      // Bit r of the returned mask is set when the tile rotated by r is compatible.
+      unsigned compatible_rotations(const tile_t& a_tile, const position_t& a_pos) const;
+
+      // Check which rotations of a tile have the needed colors, packed one per byte in
+      // direction order, in the directions selected by the present mask bytes.
+      // Bit r of the returned mask is set when the tile rotated by r has the colors.
+      static unsigned fitting_rotations(const tile_t& a_tile, std::uint64_t some_needed_colors, std::uint64_t a_present_mask);
+
       // Check if the solution has no invalid holes or borders.
       // (Hole with more than 3 sides or having more than two of the same color.)
       bool is_valid() const;
@@ -88,6 +109,9 @@ namespace dak::tantrix
       // Check if the solution has a continuous line of the given color.
       bool has_line(const color_t& a_color, bool must_be_loop) const;
 
+      // Number of tiles of the longest continuous line or loop of the given color.
+      size_t longest_line_length(const color_t& a_color) const;
+
       // Count how many occupied positions surround a position.
       size_t count_neighbours(const position_t& a_pos) const;
 
@@ -95,7 +119,8 @@ namespace dak::tantrix
       size_t count_similar_solutions() const { return my_similar_solutions_count; }
 
       // Counts how many fully-surrounded holes the solution has.
-      std::vector<hole_t> get_holes() const;
+      // The holes are allocated from the given memory resource.
+      holes_t get_holes(std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
       size_t count_holes() const;
 
       // Compare solutions.
@@ -105,6 +130,9 @@ namespace dak::tantrix
       // multiple solutions that are the same but with irrelevant differences.
       std::strong_ordering operator<=>(const solution_t& another_solution) const;
       bool operator==(const solution_t& another_solution) const;
+
+      // Hash of the solution, equal for solutions that compare equal.
+      std::uint64_t hash() const;
    
       // Check if this solution is exactly the same as another solution,
       // meaning that they have the same tiles at the same positions and orientations.
@@ -113,14 +141,26 @@ namespace dak::tantrix
       // Add a similar solution to this solution.
       void add_similar_solution(const solution_t& another_solution);
 
+      // Hash of the placed tiles, their orientation and position,
+      // independent of the order in which they were placed.
+      std::uint64_t placement_hash() const;
+
    private:
+      // Maximum number of line colors. There are only four colors.
+      static constexpr size_t max_line_colors = 4;
+
+      std::span<const color_t> line_colors() const { return { my_line_colors, my_line_colors_count }; }
+
       tile_t* internal_tile_at(const position_t& a_pos) const;
 
-      size_t gather_line_positions(const color_t& a_color, position_t some_ends[32]) const;
+      size_t gather_line_positions(const color_t& a_color, position_t some_ends[max_line_ends]) const;
       bool internal_fast_has_line(const color_t& a_color, bool must_be_loop) const;
       bool internal_slow_has_line(const color_t& a_color, bool must_be_loop) const;
 
-      puzzle_t                   my_puzzle;
+      // The solution only needs the line colors of the puzzle. Keeping them
+      // here instead of a copy of the puzzle keeps copying solutions cheap.
+      color_t                    my_line_colors[max_line_colors];
+      size_t                     my_line_colors_count = 0;
       size_t                     my_similar_solutions_count = 0;
       size_t                     my_tiles_count = 0;
       tiles_by_pos_t             my_tiles;
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_SOLUTIONS_CACHE_H
+#define DAK_TANTRIX_SOLUTIONS_CACHE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include "dak/tantrix/puzzle.h"
+#include "dak/tantrix/solution.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Version of the solver.
+   //
+   // Increase it whenever a change to the solver or to the puzzles can change
+   // the solutions that are found, so that cached solutions are not reused.
+   //
+   // 2: the first tile of single-loop triangles faces into the triangle.
+   // 3: the line ends of solutions of more than 16 tiles no longer overflow.
+
+   constexpr std::uint32_t solver_version = 3;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Canonical description of a puzzle.
+   //
+   // The order in which the tiles and line colors are given does not change
+   // the solutions, so they are sorted. The description also gives the lines
+   // or loops, the shape and the number of holes.
+
+   std::string canonical_puzzle_description(const puzzle_t& a_puzzle);
+
+   // Hash of the canonical description of the puzzle and of the solver version.
+   std::uint64_t canonical_puzzle_hash(const puzzle_t& a_puzzle, std::uint32_t a_solver_version = solver_version);
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // On-disk cache of the solutions of puzzles.
+   //
+   // Each version of the solver has its own sub-directory, in which the
+   // solutions of each puzzle are kept in a binary solutions file named
+   // after the canonical hash of the puzzle. Opening the cache removes the
+   // solutions cached by other versions of the solver.
+   //
+   // The cache is a best effort: failing to read or write an entry only
+   // means that the puzzle gets solved.
+
+   struct solutions_cache_t
+   {
+      // Open the cache in the given directory, creating it if needed.
+      solutions_cache_t(const std::filesystem::path& a_directory, std::uint32_t a_solver_version = solver_version);
+
+      // The directory used when none is given: a sub-directory of the temporary directory.
+      static std::filesystem::path default_directory();
+
+      // The directory of the entries of the solver version.
+      const std::filesystem::path& directory() const { return my_directory; }
+
+      // The file where the solutions of the puzzle are cached.
+      std::filesystem::path entry_path(const puzzle_t& a_puzzle) const;
+
+      // Find the cached solutions of the puzzle.
+      std::optional<all_solutions_t> find(const puzzle_t& a_puzzle) const;
+
+      // Cache the solutions of the puzzle. Returns false if they could not be saved.
+      bool store(const puzzle_t& a_puzzle, const all_solutions_t& some_solutions) const;
+
+   private:
+      std::filesystem::path   my_directory;
+      std::uint32_t           my_solver_version = solver_version;
+   };
+}
+
+#endif /* DAK_TANTRIX_SOLUTIONS_CACHE_H */
@@ -12,6 +12,8 @@
 #include "dak/tantrix/solution.h"
 #include "dak/tantrix/puzzle.h"
 #include "dak/tantrix/any_shape_puzzle.h"
+#include "dak/tantrix/fixed_shape_puzzle.h"
 #include "dak/tantrix/triangle_puzzle.h"
+#include "dak/tantrix/mask_puzzle.h"
 
 #endif /* DAK_TANTRIX_TANTRIX_H */
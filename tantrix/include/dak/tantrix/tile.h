@@ -9,6 +9,7 @@
 #include "dak/tantrix/color.h"
 
 #include <algorithm>
+#include <cstdint>
 
 
 namespace dak::tantrix
@@ -96,6 +97,14 @@ namespace dak::tantrix
 
       int rotation() const { return my_rotation; }
 
+      // Get the colors of the tile in the six directions, packed one per byte
+      // in direction order, for each of the six rotations of the tile: entry r
+      // is for rotate(r). The two high bytes are zero.
+      const std::uint64_t* rotated_colors() const
+      {
+         return packed_colors[my_number] + (6u - my_rotation) % 6u;
+      }
+
       // Check if the tile are the same tile, ignoring orientation.
       bool is_same(const tile_t& an_other) const
       {
@@ -112,6 +121,13 @@ namespace dak::tantrix
       // Description of tiles indexed by their number.
       static tile_description_t tiles[57];
 
+      // Packed colors indexed by tile number, then by the rotation applied to
+      // the unrotated tile, repeated so that six consecutive rotations can be
+      // read starting from any rotation.
+      static std::uint64_t packed_colors[57][12];
+      static bool pack_colors();
+      static const bool colors_packed;
+
       std::uint8_t  my_number = 0;
       std::uint8_t  my_rotation = 0;
    };
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef DAK_TANTRIX_TRANSPOSITION_TABLE_H
+#define DAK_TANTRIX_TRANSPOSITION_TABLE_H
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Bounded table of the partial solutions already visited by the solver.
+   //
+   // Only the 64-bit key of each partial solution is kept. The table never
+   // grows: when all the slots where a key could go are taken, one of the
+   // keys is evicted. The table is lock-free and can be shared by all the
+   // solver threads.
+
+   struct transposition_table_t
+   {
+      // Scramble the bits of a value to create a well-distributed key.
+      static constexpr std::uint64_t mix_key(std::uint64_t a_value)
+      {
+         a_value = (a_value ^ (a_value >> 30)) * 0xbf58476d1ce4e5b9ull;
+         a_value = (a_value ^ (a_value >> 27)) * 0x94d049bb133111ebull;
+         return a_value ^ (a_value >> 31);
+      }
+
+      // Create a table using at most the given number of bytes.
+      transposition_table_t(size_t a_memory_budget);
+
+      // Record the key of a partial solution.
+      // Return true if the key was already recorded.
+      bool check_and_insert(std::uint64_t a_key);
+
+      // Forget all recorded keys and reset the statistics.
+      void clear();
+
+      // Statistics.
+      size_t capacity() const { return my_mask + 1; }
+      size_t lookups_count() const { return my_lookups_count.load(); }
+      size_t hits_count() const { return my_hits_count.load(); }
+      size_t evictions_count() const { return my_evictions_count.load(); }
+      double hit_rate() const;
+
+   private:
+      static constexpr size_t bucket_size = 4;
+
+      std::unique_ptr<std::atomic<std::uint64_t>[]> my_slots;
+      size_t                                        my_mask = 0;
+      std::atomic<size_t>                           my_lookups_count = 0;
+      std::atomic<size_t>                           my_hits_count = 0;
+      std::atomic<size_t>                           my_evictions_count = 0;
+   };
+}
+
+#endif /* DAK_TANTRIX_TRANSPOSITION_TABLE_H */
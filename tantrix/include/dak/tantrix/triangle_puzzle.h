@@ -5,46 +5,77 @@
 
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 
-#include "dak/tantrix/puzzle.h"
+#include "dak/tantrix/fixed_shape_puzzle.h"
 #include "dak/tantrix/solution.h"
 
+#include <utility>
+
 
 namespace dak::tantrix
 {
    ////////////////////////////////////////////////////////////////////////////
    //
    // Puzzle with tiles placed in a triangle.
+   //
+   // The slots of the triangle are filled like any fixed shape puzzle.
+   // The order in which they are filled decides how early the checks of
+   // the lines bite, so it can be chosen. Every order starts in the top
+   // corner and only fills slots next to an already filled one.
 
-   struct triangle_puzzle_t : puzzle_t
+   struct triangle_puzzle_t : fixed_shape_puzzle_t
    {
+      // Order in which the slots of the triangle are filled.
+      enum class fill_order_t
+      {
+         rows,          // Row by row, alternating the direction of each row.
+         spiral,        // Inward spiral, along the border first.
+         edge_first,    // Around the border, then the inner slot with the most filled neighbours.
+         automatic,     // The order that prunes the most in a short probe of the search.
+      };
+
       // Create a puzzle.
       triangle_puzzle_t() = default;
       triangle_puzzle_t(const std::vector<tile_t>& some_tiles,
                         const std::vector<color_t>& some_line_colors,
                         bool must_be_loops,
-                        const maybe_size_t& a_holes_count = {});
+                        const maybe_size_t& a_holes_count = {},
+                        fill_order_t a_fill_order = fill_order_t::rows);
+
+      // The order used to fill the slots. An automatic order has been resolved to the chosen one.
+      fill_order_t fill_order() const { return my_fill_order; }
 
       // Solver interaction.
 
       // Create the initial list of sub-puzzles to solve.
       std::vector<sub_problem_t> create_initial_sub_problems() const;
 
-      // Create sub-puzzles from a given sub-puzzle that has its tile placed.
-      std::vector<sub_problem_t> create_sub_problems(
-         const sub_problem_t& a_current_sub_problem,
-         const solution_t& a_partial_solution) const;
-
       // Get the list of potential position for the tile-to-be-placed of the given sub-puzzle.
-      std::vector<solution_t::part_t> get_sub_problem_potential_parts(
+      // The parts are allocated from the given memory resource.
+      solution_t::parts_t get_sub_problem_potential_parts(
          const sub_problem_t& a_current_sub_problem,
-         const solution_t& a_partial_solution) const;
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) const;
 
    private:
+      // Positions of the triangle in rows order and in the given order.
+      static std::vector<position_t> row_positions(size_t a_tiles_count);
+      static std::vector<position_t> ordered_positions(const std::vector<position_t>& some_row_positions, fill_order_t a_fill_order);
+
+      // Deepest level of the search fully explored within a small budget of nodes,
+      // and the number of partial solutions at that level.
+      std::pair<size_t, size_t> probe_search() const;
+      bool probe_sub_problem(const sub_problem_t& a_sub_problem, const solution_t& a_partial_solution,
+                             size_t a_depth, size_t a_max_depth, size_t& a_leaves_count, size_t& a_budget) const;
+
       position_t next_pyramid_position(
          const sub_problem_t& a_current_sub_puzzle,
          const solution_t& a_partial_solution) const;
 
-      std::vector<position_t> my_pyramid_positions;
+      // Direction from the first slot such that it and the next direction face into
+      // the triangle, or -1 if the triangle is too small to have one.
+      int first_slot_inside_direction() const;
+
+      fill_order_t                     my_fill_order = fill_order_t::rows;
    };
 
 }
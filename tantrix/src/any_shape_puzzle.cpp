@@ -1,6 +1,10 @@
 #include "dak/tantrix/any_shape_puzzle.h"
 #include "dak/tantrix/solution.h"
 
+#include "dak/search/instrumentation.h"
+
+#include <bit>
+
 
 namespace dak::tantrix
 {
@@ -19,12 +23,16 @@ namespace dak::tantrix
       if (my_initial_tiles.size() <= 0)
          return {};
 
+      // A new search starts: the partial solutions of an earlier search must not be skipped.
+      if (my_transpositions)
+         my_transpositions->clear();
+
       std::vector<sub_problem_t> sub_puzzles;
       for (size_t i = 0; i < my_initial_tiles.size(); ++i)
       {
          sub_problem_t sub_puzzle;
          sub_puzzle.tile_to_place = my_initial_tiles.front();
-         sub_puzzle.other_tiles = { my_initial_tiles.begin() + 1, my_initial_tiles.end() };
+         sub_puzzle.other_tiles.assign(my_initial_tiles.begin() + 1, my_initial_tiles.end());
          sub_puzzle.right_sub_puzzles_count = int(i);
          sub_puzzles.emplace_back(sub_puzzle);
 
@@ -37,55 +45,85 @@ namespace dak::tantrix
       return sub_puzzles;
    }
 
-   std::vector<puzzle_t::sub_problem_t> any_shape_puzzle_t::create_sub_problems(
+   puzzle_t::sub_problems_t any_shape_puzzle_t::create_sub_problems(
          const sub_problem_t& a_current_sub_problem,
-         const solution_t& /*a_partial_solution*/) const
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource) const
    {
-      std::vector<sub_problem_t> subs;
+      sub_problems_t subs(a_resource);
+      subs.reserve(a_current_sub_problem.other_tiles.size());
+      for (const sub_problem_t& sub_puzzle : generate_sub_problems(a_current_sub_problem, a_partial_solution, a_resource))
+         subs.emplace_back(sub_puzzle);
+      return subs;
+   }
 
-      bool no_Line_found = true;
+   solution_t::parts_t any_shape_puzzle_t::get_sub_problem_potential_parts(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource) const
+   {
+      solution_t::parts_t next_positions(a_resource);
+      for (const solution_t::part_t& part : generate_sub_problem_potential_parts(a_current_sub_problem, a_partial_solution, a_resource))
+         next_positions.emplace_back(part);
+      return next_positions;
+   }
 
-      for (const auto color : my_line_colors)
-      {
-         if (!a_current_sub_problem.other_tiles[0].has_color(color))
-            continue;
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Lazy solver interaction.
+   //
+   // The sub-puzzles and parts are produced one at a time, reusing the same
+   // object each time, so the memory used does not depend on how many there
+   // are and no work is wasted when the solver abandons them early.
 
-         no_Line_found = false;
+   search::generator_t<puzzle_t::sub_problem_t> any_shape_puzzle_t::generate_sub_problems(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource) const
+   {
+      if (my_transpositions)
+         if (my_transpositions->check_and_insert(transposition_key(a_current_sub_problem, a_partial_solution)))
+            co_return;
 
-         for (size_t i = 0; i < a_current_sub_problem.other_tiles.size(); ++i)
-         {
-            if (!a_current_sub_problem.other_tiles[i].has_color(color))
-               break;
-
-            sub_problem_t sub_puzzle(a_current_sub_problem);
-            sub_puzzle.tile_to_place = sub_puzzle.other_tiles[i];
-            sub_puzzle.other_tiles.erase(sub_puzzle.other_tiles.begin() + i);
-            sub_puzzle.right_sub_puzzles_count -= 1;
-            subs.emplace_back(sub_puzzle);
-         }
-         break;
-      }
+      const auto& other_tiles = a_current_sub_problem.other_tiles;
 
-      if (no_Line_found)
+      // Only the tiles of the first line color found in the remaining tiles are
+      // candidates. The tiles are sorted by line color, so they come first.
+      // When no remaining tile has a line color, all remaining tiles are candidates.
+      std::optional<color_t> line_color;
+      for (const auto color : my_line_colors)
       {
-         for (size_t i = 0; i < a_current_sub_problem.other_tiles.size(); ++i)
+         if (other_tiles[0].has_color(color))
          {
-            sub_problem_t sub_puzzle(a_current_sub_problem);
-            sub_puzzle.tile_to_place = sub_puzzle.other_tiles[i];
-            sub_puzzle.other_tiles.erase(sub_puzzle.other_tiles.begin() + i);
-            sub_puzzle.right_sub_puzzles_count -= 1;
-            subs.emplace_back(sub_puzzle);
+            line_color = color;
+            break;
          }
       }
 
-      return subs;
+      sub_problem_t sub_puzzle(a_resource);
+      sub_puzzle.other_tiles.reserve(other_tiles.size());
+      sub_puzzle.right_sub_puzzles_count = a_current_sub_problem.right_sub_puzzles_count - 1;
+
+      for (size_t i = 0; i < other_tiles.size(); ++i)
+      {
+         if (line_color.has_value() && !other_tiles[i].has_color(line_color.value()))
+            break;
+
+         sub_puzzle.tile_to_place = other_tiles[i];
+         sub_puzzle.other_tiles.assign(other_tiles.begin(), other_tiles.begin() + i);
+         sub_puzzle.other_tiles.insert(sub_puzzle.other_tiles.end(), other_tiles.begin() + i + 1, other_tiles.end());
+         co_yield sub_puzzle;
+      }
    }
 
-   std::vector<solution_t::part_t> any_shape_puzzle_t::get_sub_problem_potential_parts(
+   // Only the rotations of the tile compatible with its neighbours are produced,
+   // checked for all six rotations at once.
+   search::generator_t<solution_t::part_t> any_shape_puzzle_t::generate_sub_problem_potential_parts(
          const sub_problem_t& a_current_sub_problem,
-         const solution_t& a_partial_solution) const
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource) const
    {
-      std::vector<solution_t::part_t> next_positions;
+      solution_t::part_t part;
 
       // The idea is that the first line is built linearly.
       //
@@ -95,9 +133,9 @@ namespace dak::tantrix
       if (a_current_sub_problem.tile_to_place.has_color(first_color))
       {
          if (a_partial_solution.tiles_count() == 0) {
-            next_positions.emplace_back(
-                  a_current_sub_problem.tile_to_place, position_t(0, 0));
-            return next_positions;
+            part = solution_t::part_t(a_current_sub_problem.tile_to_place, position_t(0, 0));
+            co_yield part;
+            co_return;
          }
          const bool is_zero = (a_current_sub_problem.right_sub_puzzles_count == 0);
          const size_t tile_index = is_zero ? 0 : (a_partial_solution.tiles_count() - 1);
@@ -118,59 +156,118 @@ namespace dak::tantrix
             if (a_partial_solution.is_occupied(new_pos))
                continue;
 
+            const unsigned rotations = a_partial_solution.compatible_rotations(a_current_sub_problem.tile_to_place, new_pos);
+            DAK_SEARCH_COUNT_REJECTED(incompatible_rotation, a_partial_solution.tiles_count(), 6 - std::popcount(rotations));
             for (int rotation = 0; rotation < 6; ++rotation) {
-               next_positions.emplace_back(
-                     a_current_sub_problem.tile_to_place.rotate(rotation), new_pos);
+               if ((rotations & (1u << rotation)) == 0)
+                  continue;
+               part = solution_t::part_t(a_current_sub_problem.tile_to_place.rotate(rotation), new_pos);
+               co_yield part;
             }
 
             break;
          }
 
-         return next_positions;
+         co_return;
       }
-      else
+
+      for (size_t i = 1; i < my_line_colors.size(); ++i)
       {
-         for (size_t i = 1; i < my_line_colors.size(); ++i)
+         const auto color = my_line_colors[i];
+         if (a_current_sub_problem.tile_to_place.has_color(color))
          {
-            const auto color = my_line_colors[i];
-            if (a_current_sub_problem.tile_to_place.has_color(color))
+            const auto border_positions = a_partial_solution.get_borders(color, a_resource);
+
+            // If there are more ends to connect around the border that the
+            // number of tiles can plug plus the number of ends we must have
+            // at the end, then there is no point in going further: we will
+            // never be able to connect them all.
+            const size_t desired_ends_count = my_must_be_loops ? 0 : 2;
+            const size_t tiles_count = a_current_sub_problem.right_sub_puzzles_count;
+            if (border_positions.size() > (tiles_count + 1) * 2 + desired_ends_count)
             {
-               auto border_positions = a_partial_solution.get_borders(color);
-
-               // If there are more ends to connect around the border that the
-               // number of tiles can plug plus the number of ends we must have
-               // at the end, then there is no point in going further: we will
-               // never be able to connect them all.
-               const size_t desired_ends_count = my_must_be_loops ? 0 : 2;
-               const size_t tiles_count = a_current_sub_problem.right_sub_puzzles_count;
-               if (border_positions.size() > (tiles_count + 1) * 2 + desired_ends_count)
-               {
-                  return {};
-               }
+               DAK_SEARCH_COUNT_REJECTED(border_bound, a_partial_solution.tiles_count(), 1);
+               co_return;
+            }
 
-               for (const position_t& new_pos : border_positions) {
-                  for (int rotation = 0; rotation < 6; ++rotation) {
-                     next_positions.emplace_back(
-                           a_current_sub_problem.tile_to_place.rotate(rotation), new_pos);
-                  }
+            for (const position_t& new_pos : border_positions) {
+               const unsigned rotations = a_partial_solution.compatible_rotations(a_current_sub_problem.tile_to_place, new_pos);
+               DAK_SEARCH_COUNT_REJECTED(incompatible_rotation, a_partial_solution.tiles_count(), 6 - std::popcount(rotations));
+               for (int rotation = 0; rotation < 6; ++rotation) {
+                  if ((rotations & (1u << rotation)) == 0)
+                     continue;
+                  part = solution_t::part_t(a_current_sub_problem.tile_to_place.rotate(rotation), new_pos);
+                  co_yield part;
                }
-               return next_positions;
             }
+            co_return;
          }
+      }
 
-         // We allow extra tiles that are not part of loops nor lines but are used to fill holes.
-         // Just return all holes they could fill.
-         std::vector<solution_t::hole_t> holes = a_partial_solution.get_holes();
-         for (auto& hole : holes) {
-            for (const position_t& new_pos : hole) {
-               for (int rotation = 0; rotation < 6; ++rotation) {
-                  next_positions.emplace_back(
-                        a_current_sub_problem.tile_to_place.rotate(rotation), new_pos);
-               }
+      // We allow extra tiles that are not part of loops nor lines but are used to fill holes.
+      // Just return all holes they could fill.
+      const solution_t::holes_t holes = a_partial_solution.get_holes(a_resource);
+      for (const auto& hole : holes) {
+         for (const position_t& new_pos : hole) {
+            const unsigned rotations = a_partial_solution.compatible_rotations(a_current_sub_problem.tile_to_place, new_pos);
+            DAK_SEARCH_COUNT_REJECTED(incompatible_rotation, a_partial_solution.tiles_count(), 6 - std::popcount(rotations));
+            for (int rotation = 0; rotation < 6; ++rotation) {
+               if ((rotations & (1u << rotation)) == 0)
+                  continue;
+               part = solution_t::part_t(a_current_sub_problem.tile_to_place.rotate(rotation), new_pos);
+               co_yield part;
             }
          }
       }
+   }
 
-      return next_positions;
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Transposition table.
+   //
+   // The same partial solution can be reached by placing the same tiles in
+   // different orders, for example when the tiles of the secondary colors
+   // grow from different border positions. The sub-puzzles that follow only
+   // depend on the placed tiles, the remaining tiles and the right-side
+   // count. While the first line is being built, they also depend on the
+   // first and last placed tiles, from which the line is extended.
+
+   void any_shape_puzzle_t::use_transposition_table(size_t a_memory_budget)
+   {
+      if (a_memory_budget > 0)
+         my_transpositions = std::make_shared<transposition_table_t>(a_memory_budget);
+      else
+         my_transpositions.reset();
+   }
+
+   any_shape_puzzle_t any_shape_puzzle_t::without_transposition_table() const
+   {
+      any_shape_puzzle_t puzzle(*this);
+      puzzle.my_transpositions.reset();
+      return puzzle;
+   }
+
+   std::uint64_t any_shape_puzzle_t::transposition_key(
+      const sub_problem_t& a_current_sub_problem,
+      const solution_t& a_partial_solution) const
+   {
+      std::uint64_t remaining_tiles = 0;
+      for (const tile_t& tile : a_current_sub_problem.other_tiles)
+         remaining_tiles |= std::uint64_t(1) << tile.number();
+
+      std::uint64_t key = a_partial_solution.placement_hash();
+      key ^= transposition_table_t::mix_key(remaining_tiles);
+      key ^= transposition_table_t::mix_key(std::uint64_t(a_current_sub_problem.right_sub_puzzles_count) ^ 0x5a5a5a5a00000000ull);
+
+      const bool building_first_line = a_current_sub_problem.other_tiles.size() > 0
+                                    && a_current_sub_problem.other_tiles[0].has_color(my_line_colors[0]);
+      if (building_first_line && a_partial_solution.tiles_count() > 0)
+      {
+         const solution_t::part_t& first_tile = a_partial_solution.tiles()[0];
+         const solution_t::part_t& last_tile = a_partial_solution.tiles()[a_partial_solution.tiles_count() - 1];
+         key ^= transposition_table_t::mix_key(std::uint64_t(first_tile.tile.number()) << 32 | std::uint64_t(last_tile.tile.number()));
+      }
+
+      return key;
    }
 }
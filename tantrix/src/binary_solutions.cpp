@@ -0,0 +1,283 @@
+#include "dak/tantrix/binary_solutions.h"
+#include "dak/tantrix/format.h"
+#include "dak/tantrix/parse.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Encoding and decoding of the binary format.
+   //
+   // Everything is written byte by byte in little-endian order, so files
+   // can be exchanged between machines.
+
+   namespace
+   {
+      constexpr int position_offset = 32;
+      constexpr int max_coordinate = 63 - position_offset;
+      constexpr int min_coordinate = -position_offset;
+      constexpr int max_tile_number = 56;
+
+      std::uint32_t encode_part(const solution_t::part_t& a_part)
+      {
+         const int x = a_part.pos.x();
+         const int y = a_part.pos.y();
+         if (x < min_coordinate || x > max_coordinate || y < min_coordinate || y > max_coordinate)
+            throw std::runtime_error("solution position too far from the origin to be saved in binary form");
+
+         return std::uint32_t(a_part.tile.number())
+              | std::uint32_t(a_part.tile.rotation()) << 6
+              | std::uint32_t(x + position_offset) << 9
+              | std::uint32_t(y + position_offset) << 15;
+      }
+
+      solution_t::part_t decode_part(const std::byte* some_bytes)
+      {
+         const std::uint32_t bits = std::uint32_t(some_bytes[0])
+                                  | std::uint32_t(some_bytes[1]) << 8
+                                  | std::uint32_t(some_bytes[2]) << 16;
+
+         // A tile with rotation R is the unrotated tile rotated by -R.
+         const int number   = int(bits & 0x3F);
+         const int rotation = int((bits >> 6) & 0x7);
+         const int x        = int((bits >> 9) & 0x3F) - position_offset;
+         const int y        = int((bits >> 15) & 0x3F) - position_offset;
+         if (number < 1 || number > max_tile_number || rotation > 5)
+            throw std::runtime_error("invalid tile in binary solutions file");
+         return solution_t::part_t(tile_t(number).rotate(6 - rotation), position_t(x, y));
+      }
+
+      void write_le(std::ostream& a_stream, std::uint32_t a_value, size_t a_bytes_count)
+      {
+         for (size_t i = 0; i < a_bytes_count; ++i)
+            a_stream.put(char((a_value >> (i * 8)) & 0xFF));
+      }
+
+      std::uint32_t read_le(const std::byte* some_bytes, size_t a_bytes_count)
+      {
+         std::uint32_t value = 0;
+         for (size_t i = 0; i < a_bytes_count; ++i)
+            value |= std::uint32_t(some_bytes[i]) << (i * 8);
+         return value;
+      }
+
+      void write_header(std::ostream& a_stream, const binary_solutions_header_t& a_header)
+      {
+         a_stream.write(a_header.magic, sizeof(a_header.magic));
+         write_le(a_stream, a_header.version, 2);
+         write_le(a_stream, a_header.tiles_count, 2);
+         write_le(a_stream, a_header.solutions_count, 4);
+         write_le(a_stream, a_header.reserved, 4);
+      }
+
+      bool read_header(const std::byte* some_bytes, size_t a_size, binary_solutions_header_t& a_header)
+      {
+         if (a_size < sizeof(binary_solutions_header_t))
+            return false;
+
+         std::memcpy(a_header.magic, some_bytes, sizeof(a_header.magic));
+         a_header.version         = std::uint16_t(read_le(some_bytes + 4, 2));
+         a_header.tiles_count     = std::uint16_t(read_le(some_bytes + 6, 2));
+         a_header.solutions_count = read_le(some_bytes + 8, 4);
+         a_header.reserved        = read_le(some_bytes + 12, 4);
+
+         return std::memcmp(a_header.magic, binary_solutions_header_t::expected_magic, sizeof(a_header.magic)) == 0;
+      }
+   }
+
+   void write_binary_solutions(std::ostream& a_stream, const all_solutions_t& some_solutions)
+   {
+      binary_solutions_header_t header;
+      header.solutions_count = std::uint32_t(some_solutions.size());
+      if (some_solutions.size() > 0)
+         header.tiles_count = std::uint16_t(some_solutions.begin()->tiles_count());
+
+      write_header(a_stream, header);
+
+      for (const solution_t& solution : some_solutions)
+      {
+         if (solution.tiles_count() != header.tiles_count)
+            throw std::runtime_error("all solutions must have the same number of tiles to be saved in binary form");
+
+         const solution_t::part_t* tiles = solution.tiles();
+         for (size_t i = 0; i < solution.tiles_count(); ++i)
+            write_le(a_stream, encode_part(tiles[i]), binary_part_size);
+      }
+   }
+
+   bool is_binary_solutions_file(const std::filesystem::path& a_path)
+   {
+      std::ifstream stream(a_path, std::ios::binary);
+      char magic[sizeof(binary_solutions_header_t::expected_magic)] = { 0 };
+      if (!stream.read(magic, sizeof(magic)))
+         return false;
+      return std::memcmp(magic, binary_solutions_header_t::expected_magic, sizeof(magic)) == 0;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Binary solutions file mapped in memory.
+
+   mapped_solutions_t::mapped_solutions_t(const std::filesystem::path& a_path)
+   {
+#ifdef _WIN32
+      HANDLE file = ::CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file == INVALID_HANDLE_VALUE)
+         throw std::runtime_error("could not open the binary solutions file");
+      my_file = reinterpret_cast<std::intptr_t>(file);
+
+      LARGE_INTEGER size;
+      if (!::GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+      {
+         unmap();
+         throw std::runtime_error("could not read the binary solutions file");
+      }
+      my_size = size_t(size.QuadPart);
+
+      my_mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (my_mapping)
+         my_data = static_cast<const std::byte*>(::MapViewOfFile(my_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+      const int file = ::open(a_path.c_str(), O_RDONLY);
+      if (file < 0)
+         throw std::runtime_error("could not open the binary solutions file");
+      my_file = file;
+
+      struct stat status;
+      if (::fstat(file, &status) != 0 || status.st_size <= 0)
+      {
+         unmap();
+         throw std::runtime_error("could not read the binary solutions file");
+      }
+      my_size = size_t(status.st_size);
+
+      void* data = ::mmap(nullptr, my_size, PROT_READ, MAP_PRIVATE, file, 0);
+      if (data != MAP_FAILED)
+         my_data = static_cast<const std::byte*>(data);
+#endif
+
+      if (!my_data)
+      {
+         unmap();
+         throw std::runtime_error("could not map the binary solutions file");
+      }
+
+      const bool is_valid = read_header(my_data, my_size, my_header)
+                         && my_header.version == binary_solutions_header_t::current_version
+                         && my_header.tiles_count <= std::extent_v<solution_t::tiles_by_pos_t>
+                         && my_size == sizeof(binary_solutions_header_t) + size_t(my_header.solutions_count) * my_header.tiles_count * binary_part_size;
+      if (!is_valid)
+      {
+         unmap();
+         throw std::runtime_error("invalid binary solutions file");
+      }
+   }
+
+   mapped_solutions_t::~mapped_solutions_t()
+   {
+      unmap();
+   }
+
+   void mapped_solutions_t::unmap()
+   {
+#ifdef _WIN32
+      if (my_data)
+         ::UnmapViewOfFile(my_data);
+      if (my_mapping)
+         ::CloseHandle(my_mapping);
+      if (my_file != -1)
+         ::CloseHandle(reinterpret_cast<HANDLE>(my_file));
+#else
+      if (my_data)
+         ::munmap(const_cast<std::byte*>(my_data), my_size);
+      if (my_file != -1)
+         ::close(int(my_file));
+#endif
+      my_data = nullptr;
+      my_mapping = nullptr;
+      my_file = -1;
+   }
+
+   const std::byte* mapped_solutions_t::record(size_t a_solution_index) const
+   {
+      return my_data + sizeof(binary_solutions_header_t) + a_solution_index * tiles_count() * binary_part_size;
+   }
+
+   solution_t::part_t mapped_solutions_t::part(size_t a_solution_index, size_t a_tile_index) const
+   {
+      return decode_part(record(a_solution_index) + a_tile_index * binary_part_size);
+   }
+
+   solution_t mapped_solutions_t::solution(size_t a_solution_index) const
+   {
+      solution_t solution({});
+      const std::byte* parts = record(a_solution_index);
+      for (size_t i = 0; i < tiles_count(); ++i)
+      {
+         const solution_t::part_t part = decode_part(parts + i * binary_part_size);
+         solution.add_part(part);
+      }
+      return solution;
+   }
+
+   all_solutions_t mapped_solutions_t::all_solutions() const
+   {
+      // The solutions were saved from a sorted set, so they are
+      // usually already in order and each goes at the end.
+      all_solutions_t solutions;
+      for (size_t i = 0; i < size(); ++i)
+         solutions.emplace_hint(solutions.end(), solution(i));
+      return solutions;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Solutions files in either format.
+
+   all_solutions_t load_solutions(const std::filesystem::path& a_path)
+   {
+      if (is_binary_solutions_file(a_path))
+         return mapped_solutions_t(a_path).all_solutions();
+
+      return parse_solutions(search::load_text_file(a_path));
+   }
+
+   void save_solutions(const std::filesystem::path& a_path, const all_solutions_t& some_solutions, bool is_binary)
+   {
+      if (is_binary)
+      {
+         std::ofstream stream(a_path, std::ios::binary);
+         write_binary_solutions(stream, some_solutions);
+      }
+      else
+      {
+         std::ofstream stream(a_path);
+         write_solutions(stream, some_solutions);
+      }
+   }
+
+   void convert_text_to_binary_solutions(const std::filesystem::path& a_text_path, const std::filesystem::path& a_binary_path)
+   {
+      save_solutions(a_binary_path, parse_solutions(search::load_text_file(a_text_path)), true);
+   }
+
+   void convert_binary_to_text_solutions(const std::filesystem::path& a_binary_path, const std::filesystem::path& a_text_path)
+   {
+      save_solutions(a_text_path, mapped_solutions_t(a_binary_path).all_solutions(), false);
+   }
+}
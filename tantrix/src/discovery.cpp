@@ -0,0 +1,122 @@
+#include "dak/tantrix/discovery.h"
+#include "dak/tantrix/stream.h"
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <type_traits>
+
+
+namespace dak::tantrix
+{
+   namespace
+   {
+      constexpr size_t max_tile_number = 56;
+
+      constexpr std::array<color_t, 4> all_colors = { color_t::red(), color_t::green(), color_t::blue(), color_t::yellow() };
+
+      // Bit N is set when tile N has the color.
+      std::uint64_t tiles_mask(const color_t& a_color)
+      {
+         std::uint64_t mask = 0;
+         for (size_t number = 1; number <= max_tile_number; ++number)
+            if (tile_t(int(number)).has_color(a_color))
+               mask |= std::uint64_t(1) << number;
+         return mask;
+      }
+
+      bool to_color(char a_letter, color_t& a_color)
+      {
+         switch (a_letter)
+         {
+            case 'R': a_color = color_t::red();    return true;
+            case 'G': a_color = color_t::green();  return true;
+            case 'B': a_color = color_t::blue();   return true;
+            case 'Y': a_color = color_t::yellow(); return true;
+            default:  return false;
+         }
+      }
+   }
+
+   std::vector<discovery_puzzle_t> discovery_puzzles(size_t a_min_tiles_count, size_t a_max_tiles_count)
+   {
+      std::array<std::uint64_t, all_colors.size()> masks;
+      for (size_t i = 0; i < all_colors.size(); ++i)
+         masks[i] = tiles_mask(all_colors[i]);
+
+      // A solution holds at most so many tiles.
+      const size_t max_tiles_count = std::min(a_max_tiles_count, std::extent_v<solution_t::tiles_by_pos_t>);
+
+      std::vector<discovery_puzzle_t> puzzles;
+      for (size_t count = std::max<size_t>(a_min_tiles_count, 1); count <= max_tiles_count; ++count)
+      {
+         // Bits 1 to N.
+         const std::uint64_t tiles = ((std::uint64_t(1) << count) - 1) << 1;
+         for (size_t i = 0; i < all_colors.size(); ++i)
+            if ((masks[i] & tiles) == tiles)
+               puzzles.push_back(discovery_puzzle_t{ count, all_colors[i] });
+      }
+
+      return puzzles;
+   }
+
+   std::shared_ptr<any_shape_puzzle_t> create_discovery_puzzle(const discovery_puzzle_t& a_discovery)
+   {
+      std::vector<tile_t> tiles;
+      for (size_t number = 1; number <= a_discovery.tiles_count; ++number)
+         tiles.emplace_back(int(number));
+
+      return std::make_shared<any_shape_puzzle_t>(tiles, line_colors_t{ a_discovery.color }, true);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Results.
+
+   void write_discovery_header(std::ostream& a_stream)
+   {
+      a_stream << "tiles,color,status,solutions,nodes,seconds\n";
+   }
+
+   void write_discovery_result(std::ostream& a_stream, const discovery_result_t& a_result)
+   {
+      a_stream << a_result.puzzle.tiles_count << "," << a_result.puzzle.color << "," << a_result.status << ","
+               << a_result.solutions_count << "," << a_result.nodes_count << "," << a_result.seconds << "\n";
+   }
+
+   discovery_results_t read_discovery_results(std::istream& a_stream)
+   {
+      discovery_results_t results;
+
+      std::string line;
+      while (std::getline(a_stream, line))
+      {
+         std::vector<std::string> fields;
+         std::istringstream field_stream(line);
+         std::string field;
+         while (std::getline(field_stream, field, ','))
+            fields.push_back(field);
+
+         discovery_result_t result;
+         if (fields.size() != 6 || fields[1].size() != 1 || !to_color(fields[1][0], result.puzzle.color))
+            continue;
+
+         try
+         {
+            result.puzzle.tiles_count = std::stoul(fields[0]);
+            result.status = fields[2];
+            result.solutions_count = std::stoul(fields[3]);
+            result.nodes_count = std::stoull(fields[4]);
+            result.seconds = std::stod(fields[5]);
+         }
+         catch (const std::exception&)
+         {
+            continue;
+         }
+
+         results[result.puzzle] = result;
+      }
+
+      return results;
+   }
+}
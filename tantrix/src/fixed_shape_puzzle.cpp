@@ -0,0 +1,235 @@
+#include "dak/tantrix/fixed_shape_puzzle.h"
+#include "dak/tantrix/solution.h"
+
+#include "dak/search/instrumentation.h"
+
+#include <bit>
+#include <stdexcept>
+
+
+namespace dak::tantrix
+{
+   void fixed_shape_puzzle_t::use_positions(std::vector<position_t>&& some_positions)
+   {
+      my_slot_positions = std::move(some_positions);
+
+      // Find the neighbours of each slot: all of them and the earlier ones.
+      my_slot_neighbours.assign(my_slot_positions.size(), slot_neighbours_t());
+      my_slot_adjacents.assign(my_slot_positions.size(), slot_adjacents_t());
+      for (size_t slot = 0; slot < my_slot_positions.size(); ++slot)
+      {
+         slot_neighbours_t& neighbours = my_slot_neighbours[slot];
+         for (size_t other = 0; other < my_slot_positions.size(); ++other)
+         {
+            const int dir = my_slot_positions[slot].relative_index(my_slot_positions[other]);
+            if (dir < 0)
+               continue;
+            my_slot_adjacents[slot].slots[dir] = std::int8_t(other);
+            if (other > slot)
+               continue;
+            neighbours.slots[neighbours.count] = std::uint8_t(other);
+            neighbours.directions[neighbours.count] = std::uint8_t(dir);
+            neighbours.count += 1;
+         }
+
+         if (slot > 0 && neighbours.count <= 0)
+            throw std::runtime_error("the slots of the shape are not connected");
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Solver interaction.
+
+   std::vector<puzzle_t::sub_problem_t> fixed_shape_puzzle_t::create_initial_sub_problems() const
+   {
+      if (my_line_colors.size() <= 0)
+         return {};
+
+      if (my_initial_tiles.size() <= 0)
+         return {};
+
+      std::vector<sub_problem_t> sub_puzzles;
+      for (size_t i = 0; i < initial_tiles().size(); ++i)
+      {
+         sub_problem_t sub_puzzle;
+         sub_puzzle.tile_to_place = my_initial_tiles[i];
+         sub_puzzle.other_tiles.assign(my_initial_tiles.begin(), my_initial_tiles.end());
+         sub_puzzle.other_tiles.erase(sub_puzzle.other_tiles.begin() + i);
+         sub_puzzles.emplace_back(sub_puzzle);
+      }
+
+      return sub_puzzles;
+   }
+
+   puzzle_t::sub_problems_t fixed_shape_puzzle_t::create_sub_problems(
+            const sub_problem_t& a_current_sub_problem,
+            const solution_t& a_partial_solution,
+            std::pmr::memory_resource* a_resource) const
+   {
+      sub_problems_t subs(a_resource);
+      subs.reserve(a_current_sub_problem.other_tiles.size());
+
+      const size_t next_slot = a_partial_solution.tiles_count();
+      if (next_slot >= my_slot_positions.size())
+         throw std::runtime_error("bug in fixed shape solver");
+      for (const color_t& line_color : my_line_colors)
+      {
+         if (!can_complete_line(line_color, a_current_sub_problem, a_partial_solution))
+         {
+            DAK_SEARCH_COUNT_REJECTED(line_bound, a_partial_solution.tiles_count(), 1);
+            return subs;
+         }
+      }
+
+      // The tile to place must have the color facing it from its most recently filled neighbour.
+      const slot_neighbours_t& neighbours = my_slot_neighbours[next_slot];
+      const int dir = neighbours.directions[neighbours.count - 1];
+      const auto& neighbour_tile = a_partial_solution.tiles()[neighbours.slots[neighbours.count - 1]];
+      const auto color = neighbour_tile.tile.color(dir + 3);
+
+      for (size_t i = 0; i < a_current_sub_problem.other_tiles.size(); ++i)
+      {
+         const tile_t& tile = a_current_sub_problem.other_tiles[i];
+         if (!tile.has_color(color))
+         {
+            DAK_SEARCH_COUNT_REJECTED(adjacent_color, a_partial_solution.tiles_count(), 1);
+            continue;
+         }
+
+         sub_problem_t& sub_puzzle = subs.emplace_back(a_current_sub_problem);
+         sub_puzzle.tile_to_place = tile;
+         sub_puzzle.other_tiles.erase(sub_puzzle.other_tiles.begin() + i);
+      }
+
+      return subs;
+   }
+
+   bool fixed_shape_puzzle_t::can_complete_line(
+            const color_t& a_color,
+            const sub_problem_t& a_current_sub_problem,
+            const solution_t& a_partial_solution) const
+   {
+      // Count the line ends that are not joined to a placed tile: those facing
+      // an empty slot and those on the border of the shape. A slot gets a
+      // single tile, which can join at most two ends.
+      const size_t placed_count = a_partial_solution.tiles_count();
+      const solution_t::part_t* placed_tiles = a_partial_solution.tiles();
+      std::uint8_t facing_counts[57] = {};
+      size_t open_ends_count = 0;
+      size_t border_ends_count = 0;
+      for (size_t slot = 0; slot < placed_count; ++slot)
+      {
+         const tile_t& tile = placed_tiles[slot].tile;
+         if (!tile.has_color(a_color))
+            continue;
+
+         for (int dir = 0; dir < 6; ++dir)
+         {
+            if (tile.color(dir) != a_color)
+               continue;
+
+            const int adjacent = my_slot_adjacents[slot].slots[dir];
+            if (adjacent < 0)
+            {
+               border_ends_count += 1;
+               continue;
+            }
+
+            if (size_t(adjacent) < placed_count)
+               continue;
+
+            open_ends_count += 1;
+            if (++facing_counts[adjacent] > 2)
+               return false;
+         }
+      }
+
+      // Loops cannot end on the border, lines only have two ends.
+      const size_t desired_ends_count = my_must_be_loops ? 0 : 2;
+      if (border_ends_count > desired_ends_count)
+         return false;
+
+      // Each remaining tile of the color can join at most two ends.
+      size_t remaining_count = 0;
+      for (const tile_t& tile : a_current_sub_problem.other_tiles)
+         if (tile.has_color(a_color))
+            remaining_count += 1;
+
+      if (open_ends_count + border_ends_count > remaining_count * 2 + desired_ends_count)
+         return false;
+
+      // A loop can only close on the last tile of its color, and lines never close.
+      if (remaining_count > 0 || !my_must_be_loops)
+         if (has_closed_loop(a_color, a_partial_solution))
+            return false;
+
+      return true;
+   }
+
+   bool fixed_shape_puzzle_t::has_closed_loop(const color_t& a_color, const solution_t& a_partial_solution) const
+   {
+      // The partial solution was checked before the last tile was placed,
+      // so only a loop through the last tile can be closed. Follow the line
+      // from the last tile until it ends or comes back.
+      const size_t placed_count = a_partial_solution.tiles_count();
+      const solution_t::part_t* placed_tiles = a_partial_solution.tiles();
+      const size_t last_slot = placed_count - 1;
+      const tile_t& last_tile = placed_tiles[last_slot].tile;
+      if (!last_tile.has_color(a_color))
+         return false;
+
+      size_t slot = last_slot;
+      direction_t dir = last_tile.find_color(a_color, 0);
+      for (size_t steps = 0; steps < placed_count; ++steps)
+      {
+         const int adjacent = my_slot_adjacents[slot].slots[dir.as_int()];
+         if (adjacent < 0 || size_t(adjacent) >= placed_count)
+            return false;
+
+         slot = size_t(adjacent);
+         if (slot == last_slot)
+            return true;
+
+         const direction_t entry = dir.rotate(3);
+         dir = placed_tiles[slot].tile.find_color(a_color, entry.rotate(1));
+      }
+
+      return false;
+   }
+
+   solution_t::parts_t fixed_shape_puzzle_t::get_sub_problem_potential_parts(
+         const sub_problem_t& a_current_sub_problem,
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource) const
+   {
+      solution_t::parts_t next_positions(a_resource);
+      next_positions.reserve(7);
+
+      // Only keep the rotations compatible with the earlier neighbours of the slot,
+      // checked for all six at once. The tile of each earlier slot is the tile
+      // placed in that order.
+      const size_t next_slot = a_partial_solution.tiles_count();
+      const position_t next_pos = my_slot_positions[next_slot];
+      const slot_neighbours_t& neighbours = my_slot_neighbours[next_slot];
+      std::uint64_t needed_colors = 0;
+      std::uint64_t present_mask = 0;
+      for (std::uint8_t i = 0; i < neighbours.count; ++i)
+      {
+         const int dir = neighbours.directions[i];
+         const tile_t& neighbour = a_partial_solution.tiles()[neighbours.slots[i]].tile;
+         needed_colors |= std::uint64_t(neighbour.color(dir + 3).as_int()) << (dir * 8);
+         present_mask |= std::uint64_t(0xFF) << (dir * 8);
+      }
+      const unsigned rotations = solution_t::fitting_rotations(a_current_sub_problem.tile_to_place, needed_colors, present_mask);
+      DAK_SEARCH_COUNT_REJECTED(incompatible_rotation, a_partial_solution.tiles_count(), 6 - std::popcount(rotations));
+      for (int rotation = 0; rotation < 6; ++rotation) {
+         if ((rotations & (1u << rotation)) == 0)
+            continue;
+         next_positions.emplace_back(
+               a_current_sub_problem.tile_to_place.rotate(rotation),
+               next_pos);
+      }
+      return next_positions;
+   }
+}
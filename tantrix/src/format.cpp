@@ -0,0 +1,44 @@
+#include "dak/tantrix/format.h"
+#include "dak/tantrix/direction.h"
+
+
+namespace dak::tantrix
+{
+   namespace
+   {
+      constexpr char color_letters[] = { 'R', 'G', 'B', 'Y' };
+   }
+
+   void write_solution(search::text_writer_t& a_writer, const solution_t& a_solution)
+   {
+      a_writer.write(a_solution.is_valid() ? "valid\n" : "invalid\n");
+
+      const solution_t::part_t* tiles = a_solution.tiles();
+      for (size_t i = 0; i < a_solution.tiles_count(); ++i)
+      {
+         const solution_t::part_t& part = tiles[i];
+         a_writer.write_number(part.pos.x()).write('/').write_number(part.pos.y()).write(": ");
+         a_writer.write_number(part.tile.number()).write(' ');
+
+         char colors[6];
+         for (const direction_t& dir : directions)
+            colors[dir.as_int()] = color_letters[part.tile.color(dir).as_int()];
+         a_writer.write(std::string_view(colors, 6)).write('\n');
+      }
+   }
+
+   void write_solutions(search::text_writer_t& a_writer, const all_solutions_t& some_solutions)
+   {
+      for (const solution_t& solution : some_solutions)
+      {
+         write_solution(a_writer, solution);
+         a_writer.write('\n');
+      }
+   }
+
+   void write_solutions(std::ostream& a_stream, const all_solutions_t& some_solutions)
+   {
+      search::text_writer_t writer(a_stream);
+      write_solutions(writer, some_solutions);
+   }
+}
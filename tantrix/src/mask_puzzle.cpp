@@ -0,0 +1,98 @@
+#include "dak/tantrix/mask_puzzle.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+
+namespace dak::tantrix
+{
+   mask_puzzle_t::mask_puzzle_t(const std::vector<tile_t>& some_tiles,
+                                const std::vector<color_t>& some_line_colors,
+                                bool must_be_loops,
+                                const mask_t& a_mask,
+                                const maybe_size_t& a_holes_count)
+      : fixed_shape_puzzle_t(some_tiles, some_line_colors, must_be_loops, a_holes_count)
+      , my_mask(a_mask)
+   {
+      for (const std::string& row : my_mask)
+         if (row.find_first_not_of("X.") != std::string::npos)
+            throw std::runtime_error("the mask can only contain X and .");
+
+      if (count_cells(my_mask) != some_tiles.size())
+         throw std::runtime_error("the mask does not have as many cells as there are tiles");
+
+      use_positions(ordered_positions(my_mask));
+   }
+
+   size_t mask_puzzle_t::count_cells(const mask_t& a_mask)
+   {
+      size_t count = 0;
+      for (const std::string& row : a_mask)
+         count += std::count(row.begin(), row.end(), 'X');
+      return count;
+   }
+
+   std::vector<position_t> mask_puzzle_t::ordered_positions(const mask_t& a_mask)
+   {
+      // The cells in reading order, which breaks ties between equal cells.
+      std::vector<position_t> cells;
+      for (size_t y = 0; y < a_mask.size(); ++y)
+         for (size_t x = 0; x < a_mask[y].size(); ++x)
+            if (a_mask[y][x] == 'X')
+               cells.emplace_back(int(x), int(y));
+
+      const size_t count = cells.size();
+      std::vector<int> neighbours_counts(count, 0);
+      for (size_t cell = 0; cell < count; ++cell)
+         for (size_t other = 0; other < count; ++other)
+            if (cells[cell].relative_index(cells[other]) >= 0)
+               neighbours_counts[cell] += 1;
+
+      std::vector<position_t> positions;
+      if (count <= 0)
+         return positions;
+      positions.reserve(count);
+
+      // Start with the cell with the fewest neighbours, like a corner.
+      const size_t first_cell = std::min_element(neighbours_counts.begin(), neighbours_counts.end()) - neighbours_counts.begin();
+      std::vector<bool> is_filled(count, false);
+      std::vector<int> filled_neighbours_counts(count, 0);
+      is_filled[first_cell] = true;
+      positions.push_back(cells[first_cell]);
+
+      // Then the cell with the most filled neighbours, preferring the one next
+      // to the last cell and then the one with the most sides outside the mask.
+      while (positions.size() < count)
+      {
+         const position_t& last_pos = positions.back();
+         for (size_t cell = 0; cell < count; ++cell)
+            if (last_pos.relative_index(cells[cell]) >= 0)
+               filled_neighbours_counts[cell] += 1;
+
+         size_t best_cell = count;
+         std::tuple<int, int, int> best_rank;
+         for (size_t cell = 0; cell < count; ++cell)
+         {
+            if (is_filled[cell] || filled_neighbours_counts[cell] <= 0)
+               continue;
+
+            const int is_next_to_last = last_pos.relative_index(cells[cell]) >= 0 ? 1 : 0;
+            const std::tuple<int, int, int> rank = { filled_neighbours_counts[cell], is_next_to_last, 6 - neighbours_counts[cell] };
+            if (best_cell >= count || rank > best_rank)
+            {
+               best_cell = cell;
+               best_rank = rank;
+            }
+         }
+
+         if (best_cell >= count)
+            throw std::runtime_error("the cells of the mask are not all connected");
+
+         is_filled[best_cell] = true;
+         positions.push_back(cells[best_cell]);
+      }
+
+      return positions;
+   }
+}
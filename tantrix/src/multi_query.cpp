@@ -0,0 +1,76 @@
+#include "dak/tantrix/multi_query.h"
+#include "dak/tantrix/any_shape_puzzle.h"
+#include "dak/tantrix/mask_puzzle.h"
+#include "dak/tantrix/solutions_cache.h"
+#include "dak/tantrix/triangle_puzzle.h"
+
+#include <map>
+#include <string>
+
+
+namespace dak::tantrix
+{
+   std::shared_ptr<puzzle_t> without_holes_count(const puzzle_t& a_puzzle)
+   {
+      if (auto triangle = dynamic_cast<const triangle_puzzle_t*>(&a_puzzle))
+         return std::make_shared<triangle_puzzle_t>(a_puzzle.initial_tiles(), a_puzzle.line_colors(), a_puzzle.must_be_loops(), puzzle_t::maybe_size_t(), triangle->fill_order());
+      else if (auto mask_puzzle = dynamic_cast<const mask_puzzle_t*>(&a_puzzle))
+         return std::make_shared<mask_puzzle_t>(a_puzzle.initial_tiles(), a_puzzle.line_colors(), a_puzzle.must_be_loops(), mask_puzzle->mask());
+      else
+         return std::make_shared<any_shape_puzzle_t>(a_puzzle.initial_tiles(), a_puzzle.line_colors(), a_puzzle.must_be_loops());
+   }
+
+   std::vector<query_group_t> group_queries(const std::vector<std::shared_ptr<puzzle_t>>& some_puzzles)
+   {
+      // Puzzles share their search when they have the same canonical
+      // description once their number of holes is removed.
+      std::vector<query_group_t> groups;
+      std::map<std::string, size_t> group_by_description;
+
+      for (size_t index = 0; index < some_puzzles.size(); ++index)
+      {
+         if (!some_puzzles[index])
+            continue;
+
+         std::shared_ptr<puzzle_t> shared_puzzle = without_holes_count(*some_puzzles[index]);
+         const auto [pos, is_new] = group_by_description.try_emplace(canonical_puzzle_description(*shared_puzzle), groups.size());
+         if (is_new)
+            groups.push_back(query_group_t{ shared_puzzle, {} });
+         groups[pos->second].query_indices.push_back(index);
+      }
+
+      return groups;
+   }
+
+   std::vector<all_solutions_t> split_solutions(
+      const query_group_t& a_group,
+      const std::vector<std::shared_ptr<puzzle_t>>& some_puzzles,
+      const all_solutions_t& some_shared_solutions)
+   {
+      std::vector<all_solutions_t> solutions_by_query(a_group.query_indices.size());
+
+      // Partition the solutions by their number of holes, only counted if needed.
+      bool needs_holes = false;
+      for (const size_t index : a_group.query_indices)
+         needs_holes |= some_puzzles[index]->holes_count().has_value();
+
+      std::map<size_t, all_solutions_t> solutions_by_holes;
+      if (needs_holes)
+         for (const solution_t& solution : some_shared_solutions)
+         {
+            all_solutions_t& solutions = solutions_by_holes[solution.count_holes()];
+            solutions.emplace_hint(solutions.end(), solution);
+         }
+
+      for (size_t i = 0; i < a_group.query_indices.size(); ++i)
+      {
+         const puzzle_t::maybe_size_t& holes_count = some_puzzles[a_group.query_indices[i]]->holes_count();
+         if (!holes_count.has_value())
+            solutions_by_query[i] = some_shared_solutions;
+         else if (auto pos = solutions_by_holes.find(holes_count.value()); pos != solutions_by_holes.end())
+            solutions_by_query[i] = pos->second;
+      }
+
+      return solutions_by_query;
+   }
+}
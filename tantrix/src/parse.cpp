@@ -0,0 +1,222 @@
+#include "dak/tantrix/parse.h"
+#include "dak/tantrix/any_shape_puzzle.h"
+#include "dak/tantrix/mask_puzzle.h"
+#include "dak/tantrix/triangle_puzzle.h"
+
+#include <string>
+#include <type_traits>
+
+
+namespace dak::tantrix
+{
+   using search::text_parser_t;
+
+   namespace
+   {
+      constexpr int max_tile_number = 56;
+      constexpr size_t max_tiles_count = std::extent_v<solution_t::tiles_by_pos_t>;
+
+      bool is_validity(std::string_view a_word)
+      {
+         return a_word == "valid" || a_word == "invalid";
+      }
+
+      bool to_color(char a_letter, color_t& a_color)
+      {
+         switch (a_letter)
+         {
+            case 'R': a_color = color_t::red();    return true;
+            case 'G': a_color = color_t::green();  return true;
+            case 'B': a_color = color_t::blue();   return true;
+            case 'Y': a_color = color_t::yellow(); return true;
+            default:  return false;
+         }
+      }
+
+      int to_tile_number(const text_parser_t& a_parser, std::string_view a_word)
+      {
+         const int number = a_parser.to_number<int>(a_word, "a tile number");
+         if (number < 1 || number > max_tile_number)
+            a_parser.fail_at(a_word, "invalid tile number " + std::string(a_word));
+         return number;
+      }
+
+      // Read a tile number followed by its six colors,
+      // then find the rotation of the tile that has these colors.
+      tile_t read_tile(text_parser_t& a_parser)
+      {
+         const std::string_view number_word = a_parser.read_word_on_line();
+         const int number = to_tile_number(a_parser, number_word);
+
+         const std::string_view colors_word = a_parser.read_word_on_line();
+         if (colors_word.size() != 6)
+            a_parser.fail_at(colors_word, "expected the six colors of tile " + std::string(number_word));
+
+         color_t colors[6];
+         for (size_t i = 0; i < 6; ++i)
+            if (!to_color(colors_word[i], colors[i]))
+               a_parser.fail_at(colors_word.substr(i), std::string("unknown color ") + colors_word[i]);
+
+         tile_t tile(number);
+         for (int i = 0; i < 6; ++i, tile.rotate_in_place(1))
+            if (tile.has_colors(colors))
+               return tile;
+
+         a_parser.fail_at(colors_word, "the colors do not match tile " + std::string(number_word));
+      }
+
+      // Read a placed tile: its position, a colon and the tile.
+      solution_t::part_t read_part(text_parser_t& a_parser)
+      {
+         const int x = a_parser.read_number<int>("a position");
+         a_parser.expect('/');
+         const int y = a_parser.read_number<int>("a position");
+         a_parser.expect(':');
+         const tile_t tile = read_tile(a_parser);
+         if (!a_parser.is_at_end_of_line())
+            a_parser.fail("unexpected text after the tile");
+         return solution_t::part_t(tile, position_t(x, y));
+      }
+
+      // Read the placed tiles of a solution, one per line, up to a blank line,
+      // the next solution or the end of the text.
+      solution_t read_parts(text_parser_t& a_parser)
+      {
+         solution_t solution({});
+         while (!a_parser.is_at_end_of_line() && !is_validity(a_parser.peek_word_on_line()))
+         {
+            if (solution.tiles_count() >= max_tiles_count)
+               a_parser.fail("a solution has at most " + std::to_string(max_tiles_count) + " tiles");
+            const solution_t::part_t part = read_part(a_parser);
+            solution.add_tile(part.tile, part.pos);
+            a_parser.skip_line();
+         }
+         return solution;
+      }
+   }
+
+   tile_t parse_tile(std::string_view a_text)
+   {
+      text_parser_t parser(a_text);
+      const tile_t tile = read_tile(parser);
+      if (!parser.is_at_end_of_line())
+         parser.fail("unexpected text after the tile");
+      return tile;
+   }
+
+   std::shared_ptr<puzzle_t> parse_puzzle(std::string_view a_text)
+   {
+      enum { none, reading_tiles, reading_lines, reading_shape, reading_holes, reading_mask } state = none;
+      enum { any_shape, triangle_shape, mask_shape } shape = any_shape;
+      bool must_be_loops = false;
+
+      std::vector<tile_t> tiles;
+      std::vector<color_t> lines;
+      puzzle_t::maybe_size_t holes_count;
+      mask_puzzle_t::mask_t mask;
+      std::string_view mask_word;
+
+      text_parser_t parser(a_text);
+      for (std::string_view word = parser.read_word(); !word.empty(); word = parser.read_word())
+      {
+         if (word == "tiles:")
+            state = reading_tiles;
+         else if (word == "lines:")
+            state = reading_lines, must_be_loops = false;
+         else if (word == "loops:")
+            state = reading_lines, must_be_loops = true;
+         else if (word == "shape:")
+            state = reading_shape;
+         else if (word == "holes:")
+            state = reading_holes;
+         else if (word == "mask:")
+            state = reading_mask, mask_word = word;
+         else if (state == reading_tiles)
+         {
+            if (tiles.size() >= max_tiles_count)
+               parser.fail_at(word, "a puzzle has at most " + std::to_string(max_tiles_count) + " tiles");
+            tiles.emplace_back(to_tile_number(parser, word));
+         }
+         else if (state == reading_lines)
+         {
+            color_t color;
+            if (word.size() != 1 || !to_color(word[0], color))
+               parser.fail_at(word, "unknown color " + std::string(word));
+            lines.push_back(color);
+         }
+         else if (state == reading_shape)
+         {
+            if (word == "triangle")
+               shape = triangle_shape;
+            else if (word == "mask")
+               shape = mask_shape;
+            else if (word == "any")
+               shape = any_shape;
+            else
+               parser.fail_at(word, "unknown shape " + std::string(word));
+         }
+         else if (state == reading_holes)
+         {
+            holes_count = parser.to_number<size_t>(word, "a number of holes");
+         }
+         else if (state == reading_mask)
+         {
+            if (word.find_first_not_of("X.") != std::string_view::npos)
+               parser.fail_at(word, "expected a row of the mask, made of X and .");
+            mask.emplace_back(word);
+         }
+         else
+         {
+            parser.fail_at(word, "expected tiles:, lines:, loops:, shape:, holes: or mask:");
+         }
+      }
+
+      if (shape == mask_shape)
+      {
+         if (mask.empty())
+            parser.fail("expected mask: with the rows of the mask shape");
+         if (mask_puzzle_t::count_cells(mask) != tiles.size())
+            parser.fail_at(mask_word, "the mask has " + std::to_string(mask_puzzle_t::count_cells(mask)) + " cells for " + std::to_string(tiles.size()) + " tiles");
+         return std::make_shared<mask_puzzle_t>(tiles, lines, must_be_loops, mask, holes_count);
+      }
+
+      if (!mask.empty())
+         parser.fail_at(mask_word, "mask: needs shape: mask");
+
+      if (shape == triangle_shape)
+         return std::make_shared<triangle_puzzle_t>(tiles, lines, must_be_loops, holes_count);
+      else
+         return std::make_shared<any_shape_puzzle_t>(tiles, lines, must_be_loops, holes_count);
+   }
+
+   solution_t parse_solution(std::string_view a_text)
+   {
+      text_parser_t parser(a_text);
+      parser.skip_white_space();
+      if (is_validity(parser.peek_word_on_line()))
+         parser.skip_line();
+      return read_parts(parser);
+   }
+
+   all_solutions_t parse_solutions(std::string_view a_text)
+   {
+      all_solutions_t solutions;
+
+      // Other lines, like the count of solutions, are ignored.
+      // Solutions are usually written in order, so each goes at the end.
+      text_parser_t parser(a_text);
+      for (std::string_view word = parser.read_word(); !word.empty(); word = parser.read_word())
+      {
+         parser.skip_line();
+         if (is_validity(word))
+            solutions.emplace_hint(solutions.end(), read_parts(parser));
+      }
+
+      return solutions;
+   }
+
+   std::shared_ptr<puzzle_t> load_puzzle(const std::filesystem::path& a_path)
+   {
+      return parse_puzzle(search::load_text_file(a_path));
+   }
+}
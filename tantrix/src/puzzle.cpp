@@ -1,7 +1,9 @@
 #include "dak/tantrix/puzzle.h"
 #include "dak/tantrix/solution.h"
 
+#include <algorithm>
 #include <set>
+#include <stdexcept>
 
 
 namespace dak::tantrix
@@ -22,7 +24,7 @@ namespace dak::tantrix
       , my_holes_count(a_holes_count)
    {
       if (!some_line_colors.size())
-         throw std::exception("invalid puzzle: no required line colors provided");
+         throw std::runtime_error("invalid puzzle: no required line colors provided");
 
       std::set<tile_t> done_tiles;
       for (const auto color : some_line_colors)
@@ -71,6 +73,22 @@ namespace dak::tantrix
       return true;
    }
 
+   std::int64_t puzzle_t::partial_solution_score(const solution_t& a_partial_solution) const
+   {
+      if (my_line_colors.size() <= 0)
+         return 0;
+
+      return std::int64_t(a_partial_solution.longest_line_length(my_line_colors[0]));
+   }
+
+   std::int64_t puzzle_t::max_partial_solution_score() const
+   {
+      if (my_line_colors.size() <= 0)
+         return 0;
+
+      return std::count_if(my_initial_tiles.begin(), my_initial_tiles.end(), [this](const tile_t& a_tile) { return a_tile.has_color(my_line_colors[0]); });
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    //
    // This is how the puzzle control the solver.
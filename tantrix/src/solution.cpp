@@ -1,9 +1,17 @@
 #include "dak/tantrix/solution.h"
 #include "dak/tantrix/puzzle.h"
+#include "dak/tantrix/transposition_table.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <set>
-#include <map>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DAK_TANTRIX_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 
 namespace dak::tantrix
@@ -21,12 +29,14 @@ namespace dak::tantrix
    //    - Add a solution if it is not already known.
 
    solution_t::solution_t(const puzzle_t& a_puzzle)
-   : my_puzzle(a_puzzle)
    {
+      for (const color_t& color : a_puzzle.line_colors())
+         if (my_line_colors_count < max_line_colors)
+            my_line_colors[my_line_colors_count++] = color;
    }
 
    solution_t::solution_t(const puzzle_t& a_puzzle, const tile_t& a_tile, const position_t& a_pos)
-   : my_puzzle(a_puzzle)
+   : solution_t(a_puzzle)
    {
       add_tile(a_tile, a_pos);
    }
@@ -44,12 +54,12 @@ namespace dak::tantrix
             return order;
       }
 
-      for (const auto& color : my_puzzle.line_colors()) {
-         std::vector<position_t> my_ends(32);
+      for (const auto& color : line_colors()) {
+         std::vector<position_t> my_ends(max_line_ends);
          const size_t my_ends_count = gather_line_positions(color, &my_ends[0]);
          std::sort(my_ends.begin(), my_ends.begin() + my_ends_count);
 
-         std::vector<position_t> other_ends(32);
+         std::vector<position_t> other_ends(max_line_ends);
          const size_t other_ends_count = another_solution.gather_line_positions(color, &other_ends[0]);
          std::sort(other_ends.begin(), other_ends.begin() + other_ends_count);
 
@@ -72,6 +82,29 @@ namespace dak::tantrix
       return (*this <=> another_solution) == std::strong_ordering::equal;
    }
 
+   std::uint64_t solution_t::hash() const
+   {
+      // Hash the same elements that are compared: the positions and the line ends.
+      std::uint64_t hash = transposition_table_t::mix_key(my_tiles_count);
+      const auto add_to_hash = [&hash](const position_t& a_pos)
+      {
+         hash = transposition_table_t::mix_key(hash ^ (std::uint64_t(std::uint8_t(a_pos.x())) << 8 | std::uint8_t(a_pos.y())));
+      };
+
+      for (size_t i = 0; i < my_tiles_count; ++i)
+         add_to_hash(my_tiles[i].pos);
+
+      for (const auto& color : line_colors()) {
+         position_t ends[max_line_ends];
+         const size_t ends_count = gather_line_positions(color, ends);
+         std::sort(ends, ends + ends_count, [](const position_t& a, const position_t& b) { return a.key() < b.key(); });
+         for (size_t i = 0; i < ends_count; ++i)
+            add_to_hash(ends[i]);
+      }
+
+      return hash;
+   }
+
    std::strong_ordering solution_t::is_identical(const tantrix::solution_t& another_solution) const
    {
       auto order = (my_tiles_count <=> another_solution.my_tiles_count);
@@ -100,6 +133,22 @@ namespace dak::tantrix
          my_similar_solutions_count += 1;
    }
    
+   std::uint64_t solution_t::placement_hash() const
+   {
+      // Summing the hash of each placed tile makes the order irrelevant.
+      std::uint64_t hash = 0;
+      for (size_t i = 0; i < my_tiles_count; ++i)
+      {
+         const part_t& placed_tile = my_tiles[i];
+         const std::uint64_t value = std::uint64_t(placed_tile.tile.number())
+                                   | std::uint64_t(placed_tile.tile.rotation()) << 8
+                                   | std::uint64_t(std::uint8_t(placed_tile.pos.x())) << 16
+                                   | std::uint64_t(std::uint8_t(placed_tile.pos.y())) << 24;
+         hash += transposition_table_t::mix_key(value);
+      }
+      return hash;
+   }
+
    void solution_t::add_tile(const tile_t& a_tile, const position_t& a_pos)
    {
       my_tiles[my_tiles_count].pos = a_pos;
@@ -140,62 +189,95 @@ namespace dak::tantrix
       for (size_t i = 0; i < my_tiles_count; ++i)
       {
          const part_t& placed_tile = my_tiles[i];
-         switch (a_part.pos.x() - placed_tile.pos.x())
+
+         const int dir = a_part.pos.relative_index(placed_tile.pos);
+         if (dir < 0)
          {
-            case -1:
-               switch (a_part.pos.y() - placed_tile.pos.y())
-               {
-                  case -1:
-                     // Not a neighbour.
-                     break;
-                  case 0:
-                     if (placed_tile.tile.color(0) != a_part.tile.color(direction_t(3)))
-                        return false;
-                     break;
-                  case 1:
-                     if (placed_tile.tile.color(5) != a_part.tile.color(direction_t(2)))
-                        return false;
-                     break;
-               }
-               break;
-            case 0:
-               switch (a_part.pos.y() - placed_tile.pos.y())
-               {
-                  case -1:
-                     if (placed_tile.tile.color(1) != a_part.tile.color(direction_t(4)))
-                        return false;
-                     break;
-                  case 0:
-                     // Same location, always incompatible!
-                     return false;
-                  case 1:
-                     if (placed_tile.tile.color(4) != a_part.tile.color(direction_t(1)))
-                        return false;
-                     break;
-               }
-               break;
-            case 1:
-               switch (a_part.pos.y() - placed_tile.pos.y())
-               {
-                  case -1:
-                     if (placed_tile.tile.color(2) != a_part.tile.color(direction_t(5)))
-                        return false;
-                     break;
-                  case 0:
-                     if (placed_tile.tile.color(3) != a_part.tile.color(direction_t(0)))
-                        return false;
-                     break;
-                  case 1:
-                     // Not a neighbour.
-                     break;
-               }
-               break;
+            // Same location, always incompatible!
+            if (placed_tile.pos == a_part.pos)
+               return false;
+            continue;
          }
+
+         if (placed_tile.tile.color(dir + 3) != a_part.tile.color(dir))
+            return false;
       }
 
       return true;
    }
 
+   // Find which of the six rotations of a tile have the needed colors.
+   //
+   // Each rotation has its six colors packed one per byte. The needed colors
+   // are packed the same way, with the present mask selecting the directions
+   // where there is a neighbour. A rotation fits when its colors match the
+   // needed colors in all the present directions.
+   static unsigned fitting_packed_rotations(const std::uint64_t some_rotated_colors[6], std::uint64_t some_needed_colors, std::uint64_t a_present_mask)
+   {
+#if defined(__AVX2__)
+      const __m256i needed = _mm256_set1_epi64x(std::int64_t(some_needed_colors));
+      const __m256i present = _mm256_set1_epi64x(std::int64_t(a_present_mask));
+      const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(some_rotated_colors));
+      const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(some_rotated_colors + 4));
+      const __m256i low_diff = _mm256_and_si256(_mm256_xor_si256(low, needed), present);
+      const __m128i high_diff = _mm_and_si128(_mm_xor_si128(high, _mm256_castsi256_si128(needed)), _mm256_castsi256_si128(present));
+      const unsigned low_fits = unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(low_diff, _mm256_setzero_si256()))));
+      const unsigned high_fits = unsigned(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(high_diff, _mm_setzero_si128()))));
+      return low_fits | (high_fits << 4);
+#elif defined(DAK_TANTRIX_USE_SSE2)
+      // Without 64-bit comparisons, compare bytes and require all eight
+      // bytes of a rotation to match.
+      const __m128i needed = _mm_set1_epi64x(std::int64_t(some_needed_colors));
+      const __m128i present = _mm_set1_epi64x(std::int64_t(a_present_mask));
+      unsigned fits = 0;
+      for (int rotation = 0; rotation < 6; rotation += 2)
+      {
+         const __m128i colors = _mm_loadu_si128(reinterpret_cast<const __m128i*>(some_rotated_colors + rotation));
+         const __m128i diff = _mm_and_si128(_mm_xor_si128(colors, needed), present);
+         const unsigned same = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())));
+         fits |= unsigned((same & 0x00FFu) == 0x00FFu) << rotation;
+         fits |= unsigned((same & 0xFF00u) == 0xFF00u) << (rotation + 1);
+      }
+      return fits;
+#else
+      unsigned fits = 0;
+      for (int rotation = 0; rotation < 6; ++rotation)
+         fits |= unsigned(((some_rotated_colors[rotation] ^ some_needed_colors) & a_present_mask) == 0) << rotation;
+      return fits;
+#endif
+   }
+
+   unsigned solution_t::compatible_rotations(const tile_t& a_tile, const position_t& a_pos) const
+   {
+      // Gather the colors the neighbours need in each direction once,
+      // then check all rotations against them together.
+      std::uint64_t needed_colors = 0;
+      std::uint64_t present_mask = 0;
+      for (size_t i = 0; i < my_tiles_count; ++i)
+      {
+         const part_t& placed_tile = my_tiles[i];
+         const int dir = a_pos.relative_index(placed_tile.pos);
+         if (dir < 0)
+         {
+            // Same location, always incompatible!
+            if (placed_tile.pos == a_pos)
+               return 0;
+            continue;
+         }
+
+         const int shift = dir * 8;
+         needed_colors |= std::uint64_t(placed_tile.tile.color(dir + 3).as_int()) << shift;
+         present_mask |= std::uint64_t(0xFF) << shift;
+      }
+
+      return fitting_rotations(a_tile, needed_colors, present_mask);
+   }
+
+   unsigned solution_t::fitting_rotations(const tile_t& a_tile, std::uint64_t some_needed_colors, std::uint64_t a_present_mask)
+   {
+      return fitting_packed_rotations(a_tile.rotated_colors(), some_needed_colors, a_present_mask);
+   }
+
    solution_t& solution_t::rotate_in_place(int rotation, const position_t& new_center)
    {
       for (size_t i = 0; i < my_tiles_count; ++i)
@@ -266,10 +348,10 @@ namespace dak::tantrix
       }
    }
 
-   std::vector<position_t> solution_t::get_borders(const std::optional<color_t>& a_color) const
+   solution_t::positions_t solution_t::get_borders(const std::optional<color_t>& a_color, std::pmr::memory_resource* a_resource) const
    {
-      std::vector<position_t> positions;
-      positions.reserve(32);
+      positions_t positions(a_resource);
+      positions.reserve(my_tiles_count * 6);
 
       for (size_t i = 0; i < my_tiles_count; ++i)
       {
@@ -303,7 +385,7 @@ namespace dak::tantrix
           && internal_slow_has_line(a_color, must_be_loop);
    }
 
-   size_t solution_t::gather_line_positions(const color_t& a_color, position_t some_ends[32]) const
+   size_t solution_t::gather_line_positions(const color_t& a_color, position_t some_ends[max_line_ends]) const
    {
       // The idea for the algorithm is to expand the grid
       // and to record the junctions between tiles are grid point
@@ -336,7 +418,7 @@ namespace dak::tantrix
 
    bool solution_t::internal_fast_has_line(const color_t& a_color, bool must_be_loop) const
    {
-      position_t ends[32];
+      position_t ends[max_line_ends];
       const size_t ends_count = gather_line_positions(a_color, ends);
 
       // No color at all.
@@ -348,7 +430,7 @@ namespace dak::tantrix
       // For loop, we must have zero ends.
 
       // This is the unfortunate expensive bit. 33% of the running time is spent here!
-      std::sort(ends, ends + ends_count);
+      std::sort(ends, ends + ends_count, [](const position_t& a, const position_t& b) { return a.key() < b.key(); });
 
       size_t line_end_count = ends_count;
       for (size_t i = 1; i < ends_count; ++i)
@@ -442,38 +524,121 @@ namespace dak::tantrix
       }
    }
 
-   bool solution_t::is_valid() const
+   size_t solution_t::longest_line_length(const color_t& a_color) const
    {
-      using counts_by_color_t = std::map<color_t, int>;
-      using colors_by_pos_t = std::map<position_t, counts_by_color_t>;
+      // Follow each line in both directions from one of its tiles,
+      // marking the tiles that were followed so each line is only
+      // followed once. In a partial solution, a tile next to a line
+      // always continues it.
+      const auto index_at = [this](const position_t& a_pos)
+      {
+         size_t index = 0;
+         while (index < my_tiles_count && my_tiles[index].pos != a_pos)
+            index += 1;
+         return index;
+      };
+
+      std::uint64_t followed = 0;
+      size_t longest = 0;
+      for (size_t start = 0; start < my_tiles_count; ++start)
+      {
+         const part_t& start_tile = my_tiles[start];
+         if ((followed & (std::uint64_t(1) << start)) || !start_tile.tile.has_color(a_color))
+            continue;
 
-      colors_by_pos_t colors_by_pos;
+         followed |= std::uint64_t(1) << start;
+         size_t length = 1;
+
+         const direction_t left_start_dir = start_tile.tile.find_color(a_color, 0);
+         const direction_t right_start_dir = start_tile.tile.find_color(a_color, left_start_dir.rotate(1));
+         for (const direction_t start_dir : { left_start_dir, right_start_dir })
+         {
+            position_t pos = start_tile.pos;
+            direction_t dir = start_dir;
+            while (true)
+            {
+               pos = pos.move(dir);
+
+               // Stop at the end of the line or when a loop is closed.
+               const size_t index = index_at(pos);
+               if (index >= my_tiles_count || (followed & (std::uint64_t(1) << index)))
+                  break;
+
+               followed |= std::uint64_t(1) << index;
+               length += 1;
+
+               // The connection point is at dir + 3, so search from dir + 4.
+               dir = my_tiles[index].tile.find_color(a_color, dir.rotate(4));
+            }
+         }
+
+         longest = std::max(longest, length);
+      }
+
+      return longest;
+   }
+
+   bool solution_t::is_valid() const
+   {
+      // Record, in a small open-addressing table, the positions around the
+      // tiles: how many tiles touch each position and if they all show it
+      // the same color. The positions of the tiles are marked as occupied.
+      //
+      // Each slot packs the position key in the high bits, then flags,
+      // the first color seen and the count of touching tiles.
+      constexpr std::uint32_t used_bit      = 1u << 15;
+      constexpr std::uint32_t occupied_bit  = 1u << 7;
+      constexpr std::uint32_t mixed_bit     = 1u << 6;
+      constexpr std::uint32_t color_shift   = 3;
+      constexpr std::uint32_t count_mask    = 7u;
+      constexpr std::uint32_t slots_count   = 256;
+
+      std::uint32_t slots[slots_count] = { 0 };
+
+      const auto find_slot = [&slots](const position_t& a_pos) -> std::uint32_t&
+      {
+         const std::uint32_t key = a_pos.key();
+         std::uint32_t index = (key * 0x9E37u) >> 8;
+         while (true)
+         {
+            std::uint32_t& slot = slots[index % slots_count];
+            if (!slot)
+               slot = (key << 16) | used_bit;
+            if ((slot >> 16) == key)
+               return slot;
+            index += 1;
+         }
+      };
 
       for (size_t i = 0; i < my_tiles_count; ++i)
       {
          const part_t& placed_tile = my_tiles[i];
+         find_slot(placed_tile.pos) |= occupied_bit;
          for (direction_t dir : directions)
          {
-            const auto new_pos = placed_tile.pos.move(dir);
-            if (is_occupied(new_pos))
-               continue;
-            const auto color = placed_tile.tile.color(dir);
-            colors_by_pos[new_pos][color] += 1;
-
-            if (colors_by_pos[new_pos][color] > 2)
-               return false;
+            std::uint32_t& slot = find_slot(placed_tile.pos.move(dir));
+            const std::uint32_t color = std::uint32_t(placed_tile.tile.color(dir).as_int());
+            const std::uint32_t count = slot & count_mask;
+            if (count == 0)
+               slot |= color << color_shift;
+            else if (((slot >> color_shift) & 3u) != color)
+               slot |= mixed_bit;
+            if (count < count_mask)
+               slot += 1;
          }
       }
 
-      for (const auto& [pos, colors] : colors_by_pos)
+      // An empty position can have at most three neighbours,
+      // and they cannot all show it the same color.
+      for (const std::uint32_t slot : slots)
       {
-         int neighbour_count = 0;
-         for (const auto& [color, count] : colors)
-         {
-            neighbour_count += count;
-            if (neighbour_count > 3)
-               return false;
-         }
+         if (!slot || (slot & occupied_bit))
+            continue;
+         const std::uint32_t count = slot & count_mask;
+         if (count > 3)
+            return false;
+         if (count == 3 && !(slot & mixed_bit))
+            return false;
       }
 
       return true;
@@ -501,11 +666,11 @@ namespace dak::tantrix
    }
 
    // Counts how many fully-surrounded holes the solution has.
-   std::vector<solution_t::hole_t> solution_t::get_holes() const
+   solution_t::holes_t solution_t::get_holes(std::pmr::memory_resource* a_resource) const
    {
-      std::vector<hole_t> holes;
+      holes_t holes(a_resource);
 
-      std::vector<position_t> borders = get_borders();
+      positions_t borders = get_borders(std::optional<color_t>(), a_resource);
 
       size_t holes_count = 0;
 
@@ -513,7 +678,7 @@ namespace dak::tantrix
       {
          holes_count += 1;
 
-         hole_t hole;
+         hole_t hole(a_resource);
          hole.emplace_back(*borders.begin());
          borders.erase(borders.begin());
 
@@ -523,7 +688,7 @@ namespace dak::tantrix
          {
             bool hole_grew = false;
             const auto end = borders.end();
-            std::vector<position_t> untouched_borders;
+            positions_t untouched_borders(a_resource);
             untouched_borders.reserve(borders.size());
             for (auto todo_pos : borders)
             {
@@ -0,0 +1,174 @@
+#include "dak/tantrix/solutions_cache.h"
+#include "dak/tantrix/binary_solutions.h"
+#include "dak/tantrix/stream.h"
+#include "dak/tantrix/mask_puzzle.h"
+#include "dak/tantrix/triangle_puzzle.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Canonical description of a puzzle.
+
+   std::string canonical_puzzle_description(const puzzle_t& a_puzzle)
+   {
+      std::vector<int> numbers;
+      for (const tile_t& tile : a_puzzle.initial_tiles())
+         numbers.push_back(tile.number());
+      std::sort(numbers.begin(), numbers.end());
+
+      line_colors_t colors = a_puzzle.line_colors();
+      std::sort(colors.begin(), colors.end());
+
+      // Written like a puzzle file, but always giving the shape.
+      std::ostringstream stream;
+      stream << "tiles:";
+      for (const int number : numbers)
+         stream << ' ' << number;
+
+      stream << (a_puzzle.must_be_loops() ? "\n" "loops:" : "\n" "lines:");
+      for (const color_t& color : colors)
+         stream << ' ' << color;
+
+      const bool is_triangle = (dynamic_cast<const triangle_puzzle_t*>(&a_puzzle) != nullptr);
+      const auto mask_puzzle = dynamic_cast<const mask_puzzle_t*>(&a_puzzle);
+      stream << "\n" "shape: " << (is_triangle ? "triangle" : mask_puzzle ? "mask" : "any");
+      if (mask_puzzle)
+      {
+         stream << "\n" "mask:";
+         for (const std::string& row : mask_puzzle->mask())
+            stream << "\n" << row;
+      }
+
+      if (a_puzzle.holes_count().has_value())
+         stream << "\n" "holes: " << a_puzzle.holes_count().value();
+
+      return stream.str();
+   }
+
+   std::uint64_t canonical_puzzle_hash(const puzzle_t& a_puzzle, std::uint32_t a_solver_version)
+   {
+      // FNV-1a, over the description followed by the version.
+      constexpr std::uint64_t fnv_offset = 0xcbf29ce484222325ull;
+      constexpr std::uint64_t fnv_prime  = 0x100000001b3ull;
+
+      std::uint64_t hash = fnv_offset;
+      const auto add_byte = [&hash](std::uint8_t a_byte)
+      {
+         hash = (hash ^ a_byte) * fnv_prime;
+      };
+
+      for (const char c : canonical_puzzle_description(a_puzzle))
+         add_byte(std::uint8_t(c));
+
+      for (size_t i = 0; i < sizeof(a_solver_version); ++i)
+         add_byte(std::uint8_t(a_solver_version >> (i * 8)));
+
+      return hash;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // On-disk cache of the solutions of puzzles.
+
+   namespace
+   {
+      const char version_prefix[] = "solver-";
+
+      std::string version_directory_name(std::uint32_t a_solver_version)
+      {
+         return version_prefix + std::to_string(a_solver_version);
+      }
+
+      // Remove the directories of the other versions of the solver.
+      void remove_stale_versions(const std::filesystem::path& a_directory, const std::string& a_current_name)
+      {
+         std::error_code error;
+         for (const auto& entry : std::filesystem::directory_iterator(a_directory, error))
+         {
+            const std::string name = entry.path().filename().string();
+            if (name.rfind(version_prefix, 0) != 0 || name == a_current_name)
+               continue;
+
+            std::error_code remove_error;
+            std::filesystem::remove_all(entry.path(), remove_error);
+         }
+      }
+   }
+
+   solutions_cache_t::solutions_cache_t(const std::filesystem::path& a_directory, std::uint32_t a_solver_version)
+   : my_directory(a_directory / version_directory_name(a_solver_version)), my_solver_version(a_solver_version)
+   {
+      std::error_code error;
+      std::filesystem::create_directories(my_directory, error);
+      remove_stale_versions(a_directory, version_directory_name(a_solver_version));
+   }
+
+   std::filesystem::path solutions_cache_t::default_directory()
+   {
+      std::error_code error;
+      return std::filesystem::temp_directory_path(error) / "tantrix_solutions_cache";
+   }
+
+   std::filesystem::path solutions_cache_t::entry_path(const puzzle_t& a_puzzle) const
+   {
+      char name[32];
+      std::snprintf(name, sizeof(name), "%016llx.solutions.bin", static_cast<unsigned long long>(canonical_puzzle_hash(a_puzzle, my_solver_version)));
+      return my_directory / name;
+   }
+
+   std::optional<all_solutions_t> solutions_cache_t::find(const puzzle_t& a_puzzle) const
+   {
+      const std::filesystem::path path = entry_path(a_puzzle);
+
+      std::error_code error;
+      if (!std::filesystem::exists(path, error))
+         return {};
+
+      try
+      {
+         return mapped_solutions_t(path).all_solutions();
+      }
+      catch (const std::exception&)
+      {
+         // A damaged entry is removed so that it gets replaced.
+         std::filesystem::remove(path, error);
+         return {};
+      }
+   }
+
+   bool solutions_cache_t::store(const puzzle_t& a_puzzle, const all_solutions_t& some_solutions) const
+   {
+      // The solutions are written to a temporary file which then replaces
+      // the entry, so that a partially written entry is never found.
+      const std::filesystem::path path = entry_path(a_puzzle);
+      std::filesystem::path temp_path = path;
+      temp_path += ".tmp";
+
+      std::error_code error;
+      try
+      {
+         {
+            std::ofstream stream(temp_path, std::ios::binary);
+            write_binary_solutions(stream, some_solutions);
+            if (!stream.flush())
+               throw std::runtime_error("could not write the cached solutions");
+         }
+         std::filesystem::rename(temp_path, path);
+         return true;
+      }
+      catch (const std::exception&)
+      {
+         std::filesystem::remove(temp_path, error);
+         return false;
+      }
+   }
+}
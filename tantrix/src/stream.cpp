@@ -1,11 +1,53 @@
 #include "dak/tantrix/tantrix.h"
 #include "dak/tantrix/stream.h"
+#include "dak/tantrix/format.h"
+#include "dak/tantrix/parse.h"
 
-#include <sstream>
 #include <string>
 
 namespace dak::tantrix
 {
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Reading is done by the text parser. Parse errors fail the stream.
+
+   namespace
+   {
+      template <class CHAR, class T, class PARSE>
+      std::basic_istream<CHAR>& parse_text(std::basic_istream<CHAR>& a_stream, const std::string& a_text, T& a_value, PARSE a_parse)
+      {
+         try
+         {
+            a_value = a_parse(a_text);
+         }
+         catch (const parse_error_t&)
+         {
+            a_stream.setstate(std::ios::failbit);
+         }
+         return a_stream;
+      }
+
+      template <class CHAR, class T, class PARSE>
+      std::basic_istream<CHAR>& parse_remaining_text(std::basic_istream<CHAR>& a_stream, T& a_value, PARSE a_parse)
+      {
+         return parse_text(a_stream, search::read_remaining_text(a_stream), a_value, a_parse);
+      }
+
+      template <class CHAR, class T, class PARSE>
+      std::basic_istream<CHAR>& parse_words(std::basic_istream<CHAR>& a_stream, size_t a_count, T& a_value, PARSE a_parse)
+      {
+         std::basic_string<CHAR> text, word;
+         for (size_t i = 0; i < a_count; ++i)
+         {
+            if (!(a_stream >> word))
+               return a_stream;
+            text += word;
+            text += CHAR(' ');
+         }
+         return parse_text(a_stream, search::narrow_text(text), a_value, a_parse);
+      }
+   }
+
    std::ostream& operator<<(std::ostream& a_stream, const direction_t& a_direction)
    {
       switch (a_direction.as_int())
@@ -140,215 +182,62 @@ namespace dak::tantrix
 
    std::istream& operator>>(std::istream& a_stream, tile_t& a_tile)
    {
-      int tile_number = 0;
-      if (a_stream >> tile_number)
-         a_tile = tile_t(tile_number);
-
-      std::string colors_buffer;
-      a_stream >> colors_buffer;
-
-      std::istringstream colors_stream(colors_buffer);
-      color_t colors[6];
-      for (int i = 0; i < 6; ++i)
-         colors_stream >> colors[i];
-
-      for (int i = 0; i < 6; ++i)
-      {
-         if (a_tile.has_colors(colors))
-            break;
-
-         a_tile.rotate_in_place(1);
-      }
-
-      return a_stream;
+      return parse_words(a_stream, 2, a_tile, parse_tile);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, tile_t& a_tile)
    {
-      int tile_number = 0;
-      if (a_stream >> tile_number)
-         a_tile = tile_t(tile_number);
-
-      std::wstring colors_buffer;
-      a_stream >> colors_buffer;
-
-      std::wistringstream colors_stream(colors_buffer);
-      color_t colors[6];
-      for (int i = 0; i < 6; ++i)
-         colors_stream >> colors[i];
-
-
-      for (int i = 0; i < 6; ++i)
-      {
-         if (a_tile.has_colors(colors))
-            break;
-
-         a_tile.rotate_in_place(1);
-      }
-
-      return a_stream;
+      return parse_words(a_stream, 2, a_tile, parse_tile);
    }
 
    std::ostream& operator<<(std::ostream& a_stream, const solution_t& a_solution)
    {
-      a_stream << (a_solution.is_valid()   ? "valid\n"   : "invalid\n");
-      const solution_t::part_t* tiles = a_solution.tiles();
-      for (size_t i = 0; i < a_solution.tiles_count(); ++i)
-      {
-         a_stream << tiles[i].pos << ": " << tiles[i].tile << "\n";
-      }
+      search::text_writer_t writer(a_stream);
+      write_solution(writer, a_solution);
       return a_stream;
    }
 
    std::wostream& operator<<(std::wostream& a_stream, const solution_t& a_solution)
    {
-      a_stream << (a_solution.is_valid() ? "valid\n" : "invalid\n");
-      const solution_t::part_t* tiles = a_solution.tiles();
-      for (size_t i = 0; i < a_solution.tiles_count(); ++i)
-      {
-         a_stream << tiles[i].pos << ": " << tiles[i].tile << "\n";
-      }
-      return a_stream;
+      search::text_writer_t writer;
+      write_solution(writer, a_solution);
+      return a_stream << writer.text().c_str();
    }
 
    std::istream& operator>>(std::istream& a_stream, solution_t& a_solution)
    {
-      std::string validity;
-      a_stream >> validity;
-      a_solution = solution_t({});
-      while (a_stream)
-      {
-         position_t pos;
-         a_stream >> pos;
-         std::string column;
-         a_stream >> column;
-         tile_t tile;
-         a_stream >> tile;
-         if (tile.is_valid())
-            a_solution.add_tile(tile, pos);
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, a_solution, parse_solution);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, solution_t& a_solution)
    {
-      std::wstring validity;
-      a_stream >> validity;
-      a_solution = solution_t({});
-      while (a_stream)
-      {
-         position_t pos;
-         a_stream >> pos;
-         std::wstring column;
-         a_stream >> column;
-         tile_t tile;
-         a_stream >> tile;
-         if (tile.is_valid())
-            a_solution.add_tile(tile, pos);
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, a_solution, parse_solution);
    }
 
    std::ostream& operator<<(std::ostream& a_stream, const all_solutions_t& some_solutions)
    {
-      a_stream << "solutions: " << some_solutions.size() << "\n";
-      for (const auto& sol : some_solutions)
-         a_stream << sol << "\n";
-
+      search::text_writer_t writer(a_stream);
+      writer.write("solutions: ").write_number(some_solutions.size()).write('\n');
+      write_solutions(writer, some_solutions);
       return a_stream;
    }
 
    std::wostream& operator<<(std::wostream& a_stream, const all_solutions_t& some_solutions)
    {
-      a_stream << L"solutions: " << some_solutions.size() << L"\n";
-      for (const auto& sol : some_solutions)
-         a_stream << sol << L"\n";
-
-      return a_stream;
+      search::text_writer_t writer;
+      writer.write("solutions: ").write_number(some_solutions.size()).write('\n');
+      write_solutions(writer, some_solutions);
+      return a_stream << writer.text().c_str();
    }
 
    std::istream& operator>>(std::istream& a_stream, all_solutions_t& some_solutions)
    {
-      some_solutions.clear();
-
-      enum { none, found_validity } state = none;
-
-      std::string solution_buffer;
-      char line_buffer[256] = { 0 };
-
-      while (a_stream.getline(line_buffer, sizeof(line_buffer) - 1))
-      {
-         std::string line(line_buffer);
-         solution_buffer.append(line);
-
-         if (line.find_first_of("\r\n") == std::string::npos)
-            solution_buffer.append("\n");
-
-         if (state == none)
-         {
-            if (line.find("valid") != std::string::npos)
-               state = found_validity;
-            else
-               solution_buffer.clear();
-         }
-         else if (state == found_validity)
-         {
-            if (line.find_first_not_of(" \t\r\n") == std::string::npos)
-            {
-               std::istringstream sol_stream(solution_buffer);
-               solution_t solution({});
-               sol_stream >> solution;
-               some_solutions.insert(std::move(solution));
-               solution_buffer.clear();
-               state = none;
-            }
-         }
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, some_solutions, parse_solutions);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, all_solutions_t& some_solutions)
    {
-      some_solutions.clear();
-
-      enum { none, found_validity } state = none;
-
-      std::wstring solution_buffer;
-      wchar_t line_buffer[256] = { 0 };
-
-      while (a_stream.getline(line_buffer, sizeof(line_buffer) - 1))
-      {
-         std::wstring line(line_buffer);
-         solution_buffer.append(line);
-
-         if (line.find_first_of(L"\r\n") == std::wstring::npos)
-            solution_buffer.append(L"\n");
-
-         if (state == none)
-         {
-            if (line.find(L"valid") != std::wstring::npos)
-               state = found_validity;
-            else
-               solution_buffer.clear();
-         }
-         else if (state == found_validity)
-         {
-            if (line.find_first_not_of(L" \t\r\n") == std::wstring::npos)
-            {
-               std::wistringstream sol_stream(solution_buffer);
-               solution_t solution({});
-               sol_stream >> solution;
-               some_solutions.insert(std::move(solution));
-               solution_buffer.clear();
-               state = none;
-            }
-         }
-      }
-
-      return a_stream;
+      return parse_remaining_text(a_stream, some_solutions, parse_solutions);
    }
 
    std::ostream& operator<<(std::ostream& a_stream, const std::shared_ptr<puzzle_t>& a_puzzle)
@@ -367,6 +256,13 @@ namespace dak::tantrix
       if (std::dynamic_pointer_cast<triangle_puzzle_t>(a_puzzle))
          a_stream << "\n" "shape: triangle";
 
+      if (auto mask_puzzle = std::dynamic_pointer_cast<mask_puzzle_t>(a_puzzle))
+      {
+         a_stream << "\n" "shape: mask" "\n" "mask:";
+         for (const auto& row : mask_puzzle->mask())
+            a_stream << "\n" << row.c_str();
+      }
+
       if (a_puzzle->holes_count().has_value())
          a_stream << "\n" "holes: " << a_puzzle->holes_count().value();
 
@@ -389,6 +285,13 @@ namespace dak::tantrix
       if (std::dynamic_pointer_cast<triangle_puzzle_t>(a_puzzle))
          a_stream << "\n" "shape: triangle";
 
+      if (auto mask_puzzle = std::dynamic_pointer_cast<mask_puzzle_t>(a_puzzle))
+      {
+         a_stream << "\n" "shape: mask" "\n" "mask:";
+         for (const auto& row : mask_puzzle->mask())
+            a_stream << "\n" << row.c_str();
+      }
+
       if (a_puzzle->holes_count().has_value())
          a_stream << "\n" "holes: " << a_puzzle->holes_count().value();
 
@@ -397,130 +300,12 @@ namespace dak::tantrix
 
    std::istream& operator>>(std::istream& a_stream, std::shared_ptr<puzzle_t>& a_puzzle)
    {
-      enum { none, reading_tiles, reading_lines, reading_loops, reading_shape, reading_holes } state = none;
-      bool must_be_loops = false;
-
-      std::vector<tile_t> tiles;
-      std::vector<color_t> lines;
-      bool is_triangle = false;
-      puzzle_t::maybe_size_t holes_count;
-
-      std::string word;
-      while (a_stream >> word)
-      {
-         if (word == "tiles:")
-            state = reading_tiles;
-         else if (word == "lines:")
-            state = reading_lines, must_be_loops = false;
-         else if (word == "loops:")
-            state = reading_lines, must_be_loops = true;
-         else if (word == "shape:")
-            state = reading_shape;
-         else if (word == "holes:")
-            state = reading_holes;
-         else if (state == reading_tiles)
-         {
-            int number;
-            if (std::istringstream(word) >> number)
-            {
-               tile_t tile(number);
-               if (tile.is_valid())
-                  tiles.push_back(tile);
-            }
-         }
-         else if (state == reading_lines)
-         {
-            color_t color;
-            if (std::istringstream(word) >> color)
-               lines.push_back(color);
-         }
-         else if (state == reading_shape)
-         {
-            if (word == "triangle")
-               is_triangle = true;
-            else if (word == "any")
-               is_triangle = false;
-         }
-         else if (state == reading_holes)
-         {
-            size_t count = 0;
-            if (std::istringstream(word) >> count)
-            {
-               holes_count = count;
-            }
-         }
-      }
-
-      if (is_triangle)
-         a_puzzle.reset(new triangle_puzzle_t(tiles, lines, must_be_loops, holes_count));
-      else
-         a_puzzle.reset(new any_shape_puzzle_t(tiles, lines, must_be_loops, holes_count));
-
-      return a_stream;
+      return parse_remaining_text(a_stream, a_puzzle, parse_puzzle);
    }
 
    std::wistream& operator>>(std::wistream& a_stream, std::shared_ptr<puzzle_t>& a_puzzle)
    {
-      enum { none, reading_tiles, reading_lines, reading_loops, reading_shape, reading_holes } state = none;
-      bool must_be_loops = false;
-
-      std::vector<tile_t> tiles;
-      std::vector<color_t> lines;
-      bool is_triangle = false;
-      puzzle_t::maybe_size_t holes_count;
-
-      std::wstring word;
-      while (a_stream >> word)
-      {
-         if (word == L"tiles:")
-            state = reading_tiles;
-         else if (word == L"lines:")
-            state = reading_lines, must_be_loops = false;
-         else if (word == L"loops:")
-            state = reading_lines, must_be_loops = true;
-         else if (word == L"shape:")
-            state = reading_shape;
-         else if (word == L"holes:")
-            state = reading_holes;
-         else if (state == reading_tiles)
-         {
-            int number;
-            if (std::wistringstream(word) >> number)
-            {
-               tile_t tile(number);
-               if (tile.is_valid())
-                  tiles.push_back(tile);
-            }
-         }
-         else if (state == reading_lines)
-         {
-            color_t color;
-            if (std::wistringstream(word) >> color)
-               lines.push_back(color);
-         }
-         else if (state == reading_shape)
-         {
-            if (word == L"triangle")
-               is_triangle = true;
-            else if (word == L"any")
-               is_triangle = false;
-         }
-         else if (state == reading_holes)
-         {
-            size_t count = 0;
-            if (std::wistringstream(word) >> count)
-            {
-               holes_count = count;
-            }
-         }
-      }
-
-      if (is_triangle)
-         a_puzzle.reset(new triangle_puzzle_t(tiles, lines, must_be_loops, holes_count));
-      else
-         a_puzzle.reset(new any_shape_puzzle_t(tiles, lines, must_be_loops, holes_count));
-
-      return a_stream;
+      return parse_remaining_text(a_stream, a_puzzle, parse_puzzle);
    }
 
 
@@ -75,4 +75,24 @@ namespace dak::tantrix
       { B, B, Y, G, Y, G, R },   // 56
    };
 
+   std::uint64_t tile_t::packed_colors[57][12];
+
+   bool tile_t::pack_colors()
+   {
+      for (int number = 0; number < 57; ++number)
+      {
+         for (int index = 0; index < 12; ++index)
+         {
+            const tile_t tile = tile_t(number).rotate(index);
+            std::uint64_t packed = 0;
+            for (int dir = 0; dir < 6; ++dir)
+               packed |= std::uint64_t(tile.color(dir).as_int()) << (dir * 8);
+            packed_colors[number][index] = packed;
+         }
+      }
+      return true;
+   }
+
+   // Filled after the tile descriptions, which are in this same file.
+   const bool tile_t::colors_packed = tile_t::pack_colors();
 }
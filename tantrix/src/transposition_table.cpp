@@ -0,0 +1,69 @@
+#include "dak/tantrix/transposition_table.h"
+
+
+namespace dak::tantrix
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Bounded table of the partial solutions already visited by the solver.
+   //
+   // The slots are grouped in small buckets. A key can only be in the bucket
+   // that starts at the slot given by its lower bits. An empty slot contains
+   // zero, so keys are forced to be non-zero.
+
+   transposition_table_t::transposition_table_t(size_t a_memory_budget)
+   {
+      size_t slots_count = bucket_size;
+      while (slots_count * 2 * sizeof(std::atomic<std::uint64_t>) <= a_memory_budget)
+         slots_count *= 2;
+
+      my_slots.reset(new std::atomic<std::uint64_t>[slots_count]);
+      my_mask = slots_count - 1;
+      clear();
+   }
+
+   void transposition_table_t::clear()
+   {
+      for (size_t i = 0; i <= my_mask; ++i)
+         my_slots[i].store(0, std::memory_order_relaxed);
+
+      my_lookups_count = 0;
+      my_hits_count = 0;
+      my_evictions_count = 0;
+   }
+
+   bool transposition_table_t::check_and_insert(std::uint64_t a_key)
+   {
+      a_key |= 1;
+
+      my_lookups_count.fetch_add(1, std::memory_order_relaxed);
+
+      const size_t first_slot = size_t(a_key) & my_mask;
+      for (size_t i = 0; i < bucket_size; ++i)
+      {
+         std::atomic<std::uint64_t>& slot = my_slots[(first_slot + i) & my_mask];
+         std::uint64_t key = slot.load(std::memory_order_relaxed);
+         if (key == 0 && slot.compare_exchange_strong(key, a_key, std::memory_order_relaxed))
+            return false;
+
+         if (key == a_key)
+         {
+            my_hits_count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+         }
+      }
+
+      // The bucket is full: replace one of the keys, selected by the upper bits of the key.
+      my_slots[(first_slot + (a_key >> 60) % bucket_size) & my_mask].store(a_key, std::memory_order_relaxed);
+      my_evictions_count.fetch_add(1, std::memory_order_relaxed);
+      return false;
+   }
+
+   double transposition_table_t::hit_rate() const
+   {
+      const size_t lookups_count = my_lookups_count.load();
+      if (!lookups_count)
+         return 0.;
+      return double(my_hits_count.load()) / double(lookups_count);
+   }
+}
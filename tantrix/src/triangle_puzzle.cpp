@@ -1,7 +1,11 @@
 #include "dak/tantrix/triangle_puzzle.h"
 #include "dak/tantrix/solution.h"
 
+#include "dak/search/instrumentation.h"
+
 #include <algorithm>
+#include <stdexcept>
+#include <tuple>
 
 
 namespace dak::tantrix
@@ -9,21 +13,49 @@ namespace dak::tantrix
    triangle_puzzle_t::triangle_puzzle_t(const std::vector<tile_t>& some_tiles,
                                         const std::vector<color_t>& some_line_colors,
                                         bool must_be_loops,
-                                        const maybe_size_t& a_holes_count)
-      : puzzle_t(some_tiles, some_line_colors, must_be_loops, a_holes_count)
+                                        const maybe_size_t& a_holes_count,
+                                        fill_order_t a_fill_order)
+      : fixed_shape_puzzle_t(some_tiles, some_line_colors, must_be_loops, a_holes_count)
+   {
+      const std::vector<position_t> rows = row_positions(some_tiles.size());
+      if (a_fill_order != fill_order_t::automatic)
+      {
+         my_fill_order = a_fill_order;
+         use_positions(ordered_positions(rows, a_fill_order));
+         return;
+      }
+
+      // Probe the start of the search with each order and keep the one
+      // that explores the deepest, then with the fewest partial solutions.
+      std::pair<size_t, size_t> best_probe;
+      for (const fill_order_t order : { fill_order_t::rows, fill_order_t::spiral, fill_order_t::edge_first })
+      {
+         use_positions(ordered_positions(rows, order));
+         const std::pair<size_t, size_t> probe = probe_search();
+         if (order == fill_order_t::rows || probe.first > best_probe.first ||
+             (probe.first == best_probe.first && probe.second < best_probe.second))
+         {
+            best_probe = probe;
+            my_fill_order = order;
+         }
+      }
+      use_positions(ordered_positions(rows, my_fill_order));
+   }
+
+   std::vector<position_t> triangle_puzzle_t::row_positions(size_t a_tiles_count)
    {
-      my_pyramid_positions.resize(some_tiles.size());
+      std::vector<position_t> positions(a_tiles_count);
 
       int line_index = 0;
       size_t pos_index = 0;
-      while (pos_index < some_tiles.size())
+      while (pos_index < a_tiles_count)
       {
          const size_t initial_pos_index = pos_index;
          position_t in_line_pos(0 - line_index, line_index);
          const int tiles_per_line = line_index + 1;
-         for (int i = 0; i < tiles_per_line && pos_index < some_tiles.size(); ++i)
+         for (int i = 0; i < tiles_per_line && pos_index < a_tiles_count; ++i)
          {
-            my_pyramid_positions[pos_index] = in_line_pos;
+            positions[pos_index] = in_line_pos;
             in_line_pos = in_line_pos.move(1, 0);
             pos_index += 1;
          }
@@ -32,25 +64,147 @@ namespace dak::tantrix
          // the previous line is near the first position of the current line.
          if (line_index % 2)
          {
-            std::reverse(my_pyramid_positions.begin() + initial_pos_index, my_pyramid_positions.begin() + pos_index);
+            std::reverse(positions.begin() + initial_pos_index, positions.begin() + pos_index);
          }
 
          line_index += 1;
       }
 
       // Place first tile at 0/0
-      const position_t down_delta = my_pyramid_positions.front();
-      for (size_t i = 0; i < my_pyramid_positions.size(); ++i)
+      if (positions.size() > 0)
+      {
+         const position_t down_delta = positions.front();
+         for (size_t i = 0; i < positions.size(); ++i)
+         {
+            positions[i] = positions[i].move(-down_delta.x(), -down_delta.y());
+         }
+      }
+
+      return positions;
+   }
+
+   std::vector<position_t> triangle_puzzle_t::ordered_positions(const std::vector<position_t>& some_row_positions, fill_order_t a_fill_order)
+   {
+      if (a_fill_order == fill_order_t::rows || some_row_positions.size() <= 1)
+         return some_row_positions;
+
+      // Slots on the border have fewer than six neighbours in the triangle.
+      const size_t count = some_row_positions.size();
+      std::vector<int> neighbours_counts(count, 0);
+      for (size_t slot = 0; slot < count; ++slot)
+         for (size_t other = 0; other < count; ++other)
+            if (some_row_positions[slot].relative_index(some_row_positions[other]) >= 0)
+               neighbours_counts[slot] += 1;
+
+      // Walk from the top corner, each time to the next slot of the order
+      // among the ones next to a filled slot. A slot is more enclosed when
+      // more of its sides face a filled slot or the outside of the triangle.
+      std::vector<bool> is_filled(count, false);
+      std::vector<position_t> positions;
+      positions.reserve(count);
+      positions.push_back(some_row_positions[0]);
+      is_filled[0] = true;
+      std::vector<int> filled_neighbours_counts(count, 0);
+      while (positions.size() < count)
       {
-         my_pyramid_positions[i] = my_pyramid_positions[i].move(-down_delta.x(), -down_delta.y());
+         const position_t& last_pos = positions.back();
+         for (size_t slot = 0; slot < count; ++slot)
+            if (last_pos.relative_index(some_row_positions[slot]) >= 0)
+               filled_neighbours_counts[slot] += 1;
+
+         size_t best_slot = count;
+         std::tuple<bool, int, int, int> best_rank;
+         for (size_t slot = 0; slot < count; ++slot)
+         {
+            if (is_filled[slot] || filled_neighbours_counts[slot] <= 0)
+               continue;
+
+            const bool is_border = neighbours_counts[slot] < 6;
+            const int is_next_to_last = last_pos.relative_index(some_row_positions[slot]) >= 0 ? 1 : 0;
+            const int outside_sides = 6 - neighbours_counts[slot];
+            const int enclosed_sides = outside_sides + filled_neighbours_counts[slot];
+
+            // The spiral stays next to the last slot, following the border when
+            // it can and otherwise hugging the filled slots. The edge-first order
+            // does the border the same way, then the most enclosed inner slot.
+            std::tuple<bool, int, int, int> rank;
+            if (a_fill_order == fill_order_t::spiral || is_border)
+               rank = { is_border && a_fill_order == fill_order_t::edge_first, is_next_to_last, outside_sides, enclosed_sides };
+            else
+               rank = { false, enclosed_sides, is_next_to_last, outside_sides };
+
+            // Ties go to the earliest slot in rows order.
+            if (best_slot >= count || rank > best_rank)
+            {
+               best_slot = slot;
+               best_rank = rank;
+            }
+         }
+
+         is_filled[best_slot] = true;
+         positions.push_back(some_row_positions[best_slot]);
       }
+
+      return positions;
+   }
+
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Probe of the start of the search, to choose the fill order.
+
+   std::pair<size_t, size_t> triangle_puzzle_t::probe_search() const
+   {
+      static constexpr size_t probe_budget = 1 << 14;
+
+      std::pair<size_t, size_t> probe;
+      const std::vector<sub_problem_t> initial_sub_problems = create_initial_sub_problems();
+      for (size_t max_depth = 1; max_depth <= slot_positions().size(); ++max_depth)
+      {
+         size_t budget = probe_budget;
+         size_t leaves_count = 0;
+         for (const sub_problem_t& sub_problem : initial_sub_problems)
+            if (!probe_sub_problem(sub_problem, solution_t(*this), 0, max_depth, leaves_count, budget))
+               return probe;
+
+         probe = { max_depth, leaves_count };
+      }
+
+      return probe;
+   }
+
+   bool triangle_puzzle_t::probe_sub_problem(
+            const sub_problem_t& a_sub_problem, const solution_t& a_partial_solution,
+            size_t a_depth, size_t a_max_depth, size_t& a_leaves_count, size_t& a_budget) const
+   {
+      for (const auto& part : get_sub_problem_potential_parts(a_sub_problem, a_partial_solution))
+      {
+         if (a_budget <= 0)
+            return false;
+         a_budget -= 1;
+
+         solution_t partial_solution(a_partial_solution);
+         partial_solution.add_part(part);
+
+         if (a_depth + 1 >= a_max_depth || !has_more_sub_problems(a_sub_problem))
+         {
+            a_leaves_count += 1;
+            continue;
+         }
+
+         for (const auto& sub_problem : create_sub_problems(a_sub_problem, partial_solution))
+            if (!probe_sub_problem(sub_problem, partial_solution, a_depth + 1, a_max_depth, a_leaves_count, a_budget))
+               return false;
+      }
+
+      return true;
    }
 
    ////////////////////////////////////////////////////////////////////////////
    //
    // Solver interaction.
    //
-   // Get the list of potential position for the tile-to-be-placed of the given sub-puzzle.
+   // The first tile of a loop puzzle has a fixed placement, the rest is done by the fixed shape puzzle.
 
    std::vector<puzzle_t::sub_problem_t> triangle_puzzle_t::create_initial_sub_problems() const
    {
@@ -69,14 +223,16 @@ namespace dak::tantrix
          // that tile *must* have adjacent colors of the line color.
          if (must_be_loops()) {
             if (my_line_colors.size() == 1) {
-               if (!tile.has_adjacent_color(my_line_colors[0]))
+               if (!tile.has_adjacent_color(my_line_colors[0])) {
+                  DAK_SEARCH_COUNT_REJECTED(adjacent_color, 0, 1);
                   continue;
+               }
             }
          }
 
          sub_problem_t sub_puzzle;
          sub_puzzle.tile_to_place = tile;
-         sub_puzzle.other_tiles = my_initial_tiles;
+         sub_puzzle.other_tiles.assign(my_initial_tiles.begin(), my_initial_tiles.end());
          sub_puzzle.other_tiles.erase(sub_puzzle.other_tiles.begin() + i);
          sub_puzzle.right_sub_puzzles_count = 0;
          sub_puzzles.emplace_back(sub_puzzle);
@@ -85,61 +241,54 @@ namespace dak::tantrix
       return sub_puzzles;
    }
 
-   std::vector<puzzle_t::sub_problem_t> triangle_puzzle_t::create_sub_problems(
-            const sub_problem_t& a_current_sub_problem,
-            const solution_t& a_partial_solution) const
+   position_t triangle_puzzle_t::next_pyramid_position(const sub_problem_t& a_current_sub_puzzle, const solution_t& a_partial_solution) const
    {
-      std::vector<sub_problem_t> subs;
-
-      const auto& last_placed_tile = a_partial_solution.tiles()[a_partial_solution.tiles_count() - 1];
-      const auto last_pos = last_placed_tile.pos;
-      const auto next_pos = next_pyramid_position(a_current_sub_problem, a_partial_solution);
-      const auto maybe_dir = last_pos.relative(next_pos);
-      if (!maybe_dir.has_value())
-         throw std::exception("bug in triangle solver");
-      const auto dir = maybe_dir.value();
-      const auto color = last_placed_tile.tile.color(dir);
-
-      for (size_t i = 0; i < a_current_sub_problem.other_tiles.size(); ++i)
-      {
-         const tile_t& tile = a_current_sub_problem.other_tiles[i];
-         if (!tile.has_color(color))
-            continue;
-
-         sub_problem_t sub_puzzle = a_current_sub_problem;
-         sub_puzzle.tile_to_place = tile;
-         sub_puzzle.other_tiles.erase(sub_puzzle.other_tiles.begin() + i);
-         subs.emplace_back(sub_puzzle);
-      }
-
-      return subs;
+      const size_t done_count = a_partial_solution.tiles_count();
+      return slot_positions()[done_count];
    }
 
-   position_t triangle_puzzle_t::next_pyramid_position(const sub_problem_t& a_current_sub_puzzle, const solution_t& a_partial_solution) const
+   int triangle_puzzle_t::first_slot_inside_direction() const
    {
-      const size_t done_count = a_partial_solution.tiles_count();
-      return my_pyramid_positions[done_count];
+      // The first slot is the top corner: its only two neighbours are next to each other.
+      const std::vector<position_t>& positions = slot_positions();
+      if (positions.size() < 3)
+         return -1;
+
+      bool is_inside[6] = {};
+      for (size_t slot = 1; slot < positions.size(); ++slot)
+         if (const int dir = positions[0].relative_index(positions[slot]); dir >= 0)
+            is_inside[dir] = true;
+
+      for (int dir = 0; dir < 6; ++dir)
+         if (is_inside[dir] && is_inside[(dir + 1) % 6])
+            return dir;
+
+      return -1;
    }
 
-   std::vector<solution_t::part_t> triangle_puzzle_t::get_sub_problem_potential_parts(
+   solution_t::parts_t triangle_puzzle_t::get_sub_problem_potential_parts(
          const sub_problem_t& a_current_sub_problem,
-         const solution_t& a_partial_solution) const
+         const solution_t& a_partial_solution,
+         std::pmr::memory_resource* a_resource) const
    {
-      std::vector<solution_t::part_t> next_positions;
+      solution_t::parts_t next_positions(a_resource);
+      next_positions.reserve(7);
 
       // For the first tile of triangle puzzle with a single loop,
       // that first tile was already selected to have adjacent colors of the line color,
-      // so we can just place it in the first position with the right orientation.
+      // so we can just place it in the first position with the loop facing into the triangle.
       if (must_be_loops()) {
          if (a_partial_solution.tiles_count() <= 0) {
             if (my_line_colors.size() == 1) {
+               const int inside_dir = first_slot_inside_direction();
                const color_t line_color = my_line_colors[0];
                const tile_t& tile = a_current_sub_problem.tile_to_place;
-               for (int dir = 0; dir < 6; ++dir) {
+               for (int dir = 0; dir < 6 && inside_dir >= 0; ++dir) {
                   if (tile.color(dir) == line_color &&
                       tile.color(dir + 1) == line_color) {
+                        // Rotating by N moves the color of a side N directions forward.
                         next_positions.emplace_back(
-                              tile.rotate(dir),
+                              tile.rotate(inside_dir - dir),
                               next_pyramid_position(a_current_sub_problem, a_partial_solution));
                      break;
                   }
@@ -148,11 +297,10 @@ namespace dak::tantrix
          }
       }
 
-      for (int rotation = 0; rotation < 6; ++rotation) {
-         next_positions.emplace_back(
-               a_current_sub_problem.tile_to_place.rotate(rotation),
-               next_pyramid_position(a_current_sub_problem, a_partial_solution));
-      }
+      // Otherwise, only keep the rotations compatible with the neighbours.
+      if (next_positions.size() <= 0)
+         return fixed_shape_puzzle_t::get_sub_problem_potential_parts(a_current_sub_problem, a_partial_solution, a_resource);
+
       return next_positions;
    }
 }
@@ -0,0 +1,190 @@
+#include "dak/tantrix/tantrix.h"
+#include "dak/tantrix/binary_solutions.h"
+#include "dak/tantrix/discovery.h"
+#include "dak/tantrix/stream.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/search/thread_pool.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace dak::tantrix;
+using namespace dak::search;
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Sweep of the Discovery puzzles.
+//
+// Solve the loop of each color through the tiles 1 to N, for each N of a
+// range. The result of each puzzle is printed and appended to the results
+// file as soon as it is solved. When the results file already exists, the
+// puzzles it has are skipped, so a stopped sweep resumes where it was.
+// Puzzles that were stopped by the time limit are only solved again when
+// asked to.
+//
+// Each puzzle is solved by all the threads of a single thread pool, kept
+// for the whole sweep.
+
+using clock_type = chrono::steady_clock;
+using path = filesystem::path;
+
+// Error thrown by the progress to stop a search that takes too long.
+struct time_limit_error_t : runtime_error
+{
+   time_limit_error_t() : runtime_error("time limit reached") {}
+};
+
+// Progress that stops the search after the time limit, if there is one.
+struct discovery_progress_t : search_progress_t
+{
+   discovery_progress_t(chrono::seconds a_time_limit)
+   : search_progress_t(100000), my_time_limit(a_time_limit), my_start(clock_type::now())
+   {
+   }
+
+   void update_progress(size_t /*a_total_count_so_far*/) override
+   {
+      if (my_time_limit.count() > 0 && clock_type::now() - my_start > my_time_limit)
+         throw time_limit_error_t();
+   }
+
+private:
+   chrono::seconds         my_time_limit;
+   clock_type::time_point  my_start;
+};
+
+static string discovery_name(const discovery_puzzle_t& a_discovery)
+{
+   ostringstream stream;
+   stream << "Discovery " << a_discovery.tiles_count << " " << a_discovery.color;
+   return stream.str();
+}
+
+static discovery_result_t solve_discovery(const discovery_puzzle_t& a_discovery, chrono::seconds a_time_limit,
+                                          size_t a_transposition_megabytes, const path& a_solutions_folder, thread_pool_t& a_thread_pool)
+{
+   discovery_result_t result;
+   result.puzzle = a_discovery;
+
+   const shared_ptr<any_shape_puzzle_t> puzzle = create_discovery_puzzle(a_discovery);
+   puzzle->use_transposition_table(a_transposition_megabytes * 1024 * 1024);
+
+   discovery_progress_t progress(a_time_limit);
+   const auto start = clock_type::now();
+   try
+   {
+      const all_solutions_t solutions = solver_t<any_shape_puzzle_t, solution_t>::solve(*puzzle, solution_t(*puzzle), progress, a_thread_pool);
+      result.status = "solved";
+      result.solutions_count = solutions.size();
+      if (!a_solutions_folder.empty())
+         save_solutions(a_solutions_folder / (discovery_name(a_discovery) + ".solutions.txt"), solutions, false);
+   }
+   catch (const time_limit_error_t&)
+   {
+      result.status = "timeout";
+   }
+
+   result.seconds = chrono::duration<double>(clock_type::now() - start).count();
+   result.nodes_count = progress.counters().nodes_count();
+   return result;
+}
+
+static void print_usage()
+{
+   cout << "usage: tantrix_discovery [options]" << endl;
+   cout << "   --from N                  smallest number of tiles (3)" << endl;
+   cout << "   --to N                    largest number of tiles (30)" << endl;
+   cout << "   --results FILE            results file, resumed when it exists (discovery.csv)" << endl;
+   cout << "   --retry-timeouts          solve again the puzzles that were stopped by the time limit" << endl;
+   cout << "   --time-limit S            stop each puzzle after that many seconds, 0 for no limit (0)" << endl;
+   cout << "   --threads N               number of solver threads, 0 for one per hardware thread (0)" << endl;
+   cout << "   --transposition-table MB  size of the transposition table (0)" << endl;
+   cout << "   --solutions DIR           folder where the solutions are written" << endl;
+}
+
+int main(int arg_count, char** arg_values)
+{
+   size_t min_tiles_count = 3;
+   size_t max_tiles_count = 30;
+   path results_filename = "discovery.csv";
+   bool retry_timeouts = false;
+   chrono::seconds time_limit(0);
+   size_t threads_count = 0;
+   size_t transposition_megabytes = 0;
+   path solutions_folder;
+
+   try
+   {
+      for (int arg_index = 1; arg_index < arg_count; ++arg_index)
+      {
+         const string arg(arg_values[arg_index]);
+         const bool has_value = arg_index + 1 < arg_count;
+         if (arg == "--from" && has_value)
+            min_tiles_count = stoul(arg_values[++arg_index]);
+         else if (arg == "--to" && has_value)
+            max_tiles_count = stoul(arg_values[++arg_index]);
+         else if (arg == "--results" && has_value)
+            results_filename = arg_values[++arg_index];
+         else if (arg == "--retry-timeouts")
+            retry_timeouts = true;
+         else if (arg == "--time-limit" && has_value)
+            time_limit = chrono::seconds(stoul(arg_values[++arg_index]));
+         else if (arg == "--threads" && has_value)
+            threads_count = stoul(arg_values[++arg_index]);
+         else if (arg == "--transposition-table" && has_value)
+            transposition_megabytes = stoul(arg_values[++arg_index]);
+         else if (arg == "--solutions" && has_value)
+            solutions_folder = arg_values[++arg_index];
+         else
+         {
+            print_usage();
+            return 1;
+         }
+      }
+
+      discovery_results_t previous_results;
+      {
+         ifstream stream(results_filename);
+         previous_results = read_discovery_results(stream);
+      }
+
+      if (!solutions_folder.empty())
+         filesystem::create_directories(solutions_folder);
+
+      const bool is_new_file = !filesystem::exists(results_filename) || filesystem::file_size(results_filename) == 0;
+      ofstream results_stream(results_filename, ios::app);
+      if (is_new_file)
+         write_discovery_header(results_stream);
+
+      thread_pool_t thread_pool(threads_count);
+
+      for (const discovery_puzzle_t& discovery : discovery_puzzles(min_tiles_count, max_tiles_count))
+      {
+         if (auto pos = previous_results.find(discovery); pos != previous_results.end())
+            if (!retry_timeouts || pos->second.status != "timeout")
+               continue;
+
+         cout << discovery_name(discovery) << ": " << flush;
+         const discovery_result_t result = solve_discovery(discovery, time_limit, transposition_megabytes, solutions_folder, thread_pool);
+         cout << result.status << ", " << result.solutions_count << " solutions, "
+              << result.nodes_count << " nodes, " << result.seconds << "s" << endl;
+
+         write_discovery_result(results_stream, result);
+         results_stream.flush();
+      }
+
+      return 0;
+   }
+   catch (const exception& ex)
+   {
+      cerr << ex.what() << endl;
+      return 1;
+   }
+}
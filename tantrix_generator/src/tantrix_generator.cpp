@@ -0,0 +1,372 @@
+#include "dak/tantrix/tantrix.h"
+#include "dak/tantrix/binary_solutions.h"
+#include "dak/tantrix/solutions_cache.h"
+#include "dak/tantrix/stream.h"
+#include "dak/search/estimate.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/search/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace dak::tantrix;
+using namespace dak::search;
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Generator of puzzles with a unique solution.
+//
+// Each worker picks random line colors and a random set of tiles having
+// those colors, then solves the puzzle, stopping at the second solution.
+// A puzzle is kept when it has exactly one solution and its search took
+// a number of nodes within the difficulty target.
+//
+// Stopping at two solutions means that the search of a kept puzzle went
+// through its whole search tree, so its node count is its true difficulty.
+// Candidates whose estimated tree is far too big are skipped before being
+// solved, and searches are stopped as soon as they go over the target.
+
+using clock_type = chrono::steady_clock;
+using path = filesystem::path;
+
+// The estimate is noisy, only skip candidates far over the target.
+constexpr double estimate_margin = 4.;
+
+// Once a worker only draws puzzles already seen, the candidates are taken to be all used.
+constexpr size_t max_consecutive_duplicates = 10000;
+
+// Options of the generation.
+struct generator_options_t
+{
+   size_t      puzzles_count = 10;
+   size_t      tiles_count = 10;
+   bool        is_triangle = true;
+   size_t      colors_count = 1;
+   bool        must_be_loops = false;
+   uint64_t    min_nodes = 0;
+   uint64_t    max_nodes = 10000000;
+   size_t      workers_count = 0;
+   uint64_t    seed = 0;
+   chrono::seconds time_limit = chrono::seconds(0);
+   path        output_folder = "generated";
+};
+
+// State shared by the workers.
+struct generator_state_t
+{
+   mutex             my_lock;
+   set<string>       my_seen_puzzles;
+   size_t            my_accepted_count = 0;
+   atomic<size_t>    my_candidates_count = 0;
+   atomic<size_t>    my_duplicates_count = 0;
+   atomic<size_t>    my_no_solution_count = 0;
+   atomic<size_t>    my_many_solutions_count = 0;
+   atomic<size_t>    my_too_easy_count = 0;
+   atomic<size_t>    my_too_hard_count = 0;
+   atomic<bool>      my_is_done = false;
+   atomic<bool>      my_is_exhausted = false;
+   clock_type::time_point my_start = clock_type::now();
+};
+
+// Error thrown by the progress to stop a search that goes over the target.
+struct too_hard_error_t : runtime_error
+{
+   too_hard_error_t() : runtime_error("too many nodes") {}
+};
+
+// Progress that stops the search at the second solution or once over the target.
+struct generator_progress_t : search_progress_t
+{
+   generator_progress_t(uint64_t a_max_nodes)
+   : search_progress_t(10000), my_max_nodes(a_max_nodes)
+   {
+      set_solutions_limit(2);
+   }
+
+   void update_progress(size_t /*a_total_count_so_far*/) override
+   {
+      if (my_max_nodes > 0 && counters().nodes_count() > my_max_nodes)
+         throw too_hard_error_t();
+   }
+
+private:
+   uint64_t my_max_nodes;
+};
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Candidates.
+
+// Pick the line colors, then the tiles among those having all of them.
+static shared_ptr<puzzle_t> create_candidate(const generator_options_t& some_options, mt19937_64& a_random)
+{
+   vector<color_t> colors = { color_t::red(), color_t::green(), color_t::blue(), color_t::yellow() };
+   shuffle(colors.begin(), colors.end(), a_random);
+   colors.resize(some_options.colors_count);
+   sort(colors.begin(), colors.end());
+
+   vector<tile_t> tiles;
+   for (int number = 1; number <= 56; ++number)
+      if (all_of(colors.begin(), colors.end(), [number](const color_t& a_color) { return tile_t(number).has_color(a_color); }))
+         tiles.emplace_back(number);
+
+   if (tiles.size() < some_options.tiles_count)
+      throw runtime_error("not enough tiles have the line colors");
+
+   shuffle(tiles.begin(), tiles.end(), a_random);
+   tiles.resize(some_options.tiles_count);
+   sort(tiles.begin(), tiles.end());
+
+   if (some_options.is_triangle)
+      return make_shared<triangle_puzzle_t>(tiles, colors, some_options.must_be_loops);
+   else
+      return make_shared<any_shape_puzzle_t>(tiles, colors, some_options.must_be_loops);
+}
+
+// Check that the estimated search is not far over the target.
+template <class PUZZLE>
+static bool is_estimate_in_range(const PUZZLE& a_puzzle, const generator_options_t& some_options)
+{
+   if (some_options.max_nodes <= 0)
+      return true;
+
+   const estimate_t estimate = estimator_t<PUZZLE, solution_t>::estimate(a_puzzle, solution_t(a_puzzle), 100);
+   return estimate.nodes_count <= estimate_margin * double(some_options.max_nodes);
+}
+
+template <class PUZZLE>
+static all_solutions_t solve_candidate(const PUZZLE& a_puzzle, const generator_options_t& some_options, generator_progress_t& a_progress, thread_pool_t& a_thread_pool)
+{
+   if (!is_estimate_in_range(a_puzzle, some_options))
+      throw too_hard_error_t();
+
+   return solver_t<PUZZLE, solution_t>::solve(a_puzzle, solution_t(a_puzzle), a_progress, a_thread_pool);
+}
+
+static all_solutions_t solve_candidate(const shared_ptr<puzzle_t>& a_puzzle, const generator_options_t& some_options, generator_progress_t& a_progress, thread_pool_t& a_thread_pool)
+{
+   if (auto tri = dynamic_pointer_cast<triangle_puzzle_t>(a_puzzle))
+      return solve_candidate(*tri, some_options, a_progress, a_thread_pool);
+
+   if (auto shape = dynamic_pointer_cast<any_shape_puzzle_t>(a_puzzle))
+      return solve_candidate(*shape, some_options, a_progress, a_thread_pool);
+
+   throw runtime_error("invalid puzzle");
+}
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Workers.
+
+static bool is_time_over(const generator_options_t& some_options, const generator_state_t& a_state)
+{
+   return some_options.time_limit.count() > 0 && clock_type::now() - a_state.my_start > some_options.time_limit;
+}
+
+// Record a new puzzle unless it was already seen. Return false if it was seen.
+static bool remember_puzzle(const shared_ptr<puzzle_t>& a_puzzle, generator_state_t& a_state)
+{
+   lock_guard lock(a_state.my_lock);
+   return a_state.my_seen_puzzles.insert(canonical_puzzle_description(*a_puzzle)).second;
+}
+
+// Write the puzzle and its solution, unless enough puzzles were already generated.
+static void save_puzzle(const shared_ptr<puzzle_t>& a_puzzle, const all_solutions_t& some_solutions, uint64_t a_nodes_count,
+                        const generator_options_t& some_options, generator_state_t& a_state)
+{
+   lock_guard lock(a_state.my_lock);
+   if (a_state.my_accepted_count >= some_options.puzzles_count)
+      return;
+
+   a_state.my_accepted_count += 1;
+   if (a_state.my_accepted_count >= some_options.puzzles_count)
+      a_state.my_is_done = true;
+
+   ostringstream name;
+   name << "Generated Puzzle " << setw(4) << setfill('0') << a_state.my_accepted_count;
+   const path puzzle_filename = some_options.output_folder / (name.str() + ".txt");
+   {
+      ofstream stream(puzzle_filename);
+      stream << a_puzzle << endl;
+   }
+   save_solutions(path(puzzle_filename).replace_extension("solutions.txt"), some_solutions, false);
+
+   cout << name.str() << ": nodes: " << a_nodes_count << endl;
+}
+
+static void generate_puzzles(size_t a_worker_index, const generator_options_t& some_options, generator_state_t& a_state)
+{
+   mt19937_64 random(some_options.seed + a_worker_index);
+   thread_pool_t thread_pool(1);
+
+   size_t consecutive_duplicates_count = 0;
+   while (!a_state.my_is_done && !is_time_over(some_options, a_state))
+   {
+      const shared_ptr<puzzle_t> puzzle = create_candidate(some_options, random);
+      if (!remember_puzzle(puzzle, a_state))
+      {
+         a_state.my_duplicates_count += 1;
+         consecutive_duplicates_count += 1;
+         if (consecutive_duplicates_count >= max_consecutive_duplicates)
+         {
+            a_state.my_is_exhausted = true;
+            a_state.my_is_done = true;
+         }
+         continue;
+      }
+
+      consecutive_duplicates_count = 0;
+      a_state.my_candidates_count += 1;
+
+      generator_progress_t progress(some_options.max_nodes);
+      all_solutions_t solutions;
+      try
+      {
+         solutions = solve_candidate(puzzle, some_options, progress, thread_pool);
+      }
+      catch (const too_hard_error_t&)
+      {
+         a_state.my_too_hard_count += 1;
+         continue;
+      }
+
+      const uint64_t nodes_count = progress.counters().nodes_count();
+      if (solutions.size() <= 0)
+         a_state.my_no_solution_count += 1;
+      else if (solutions.size() > 1)
+         a_state.my_many_solutions_count += 1;
+      else if (nodes_count < some_options.min_nodes)
+         a_state.my_too_easy_count += 1;
+      else if (some_options.max_nodes > 0 && nodes_count > some_options.max_nodes)
+         a_state.my_too_hard_count += 1;
+      else
+         save_puzzle(puzzle, solutions, nodes_count, some_options, a_state);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Main.
+
+static void print_usage()
+{
+   cout << "usage: tantrix_generator [options]" << endl;
+   cout << "   --count N        number of puzzles to generate (10)" << endl;
+   cout << "   --tiles N        number of tiles of each puzzle (10)" << endl;
+   cout << "   --shape S        triangle or any (triangle)" << endl;
+   cout << "   --colors N       number of line colors, 1 or 2 (1)" << endl;
+   cout << "   --loops          the lines must be loops" << endl;
+   cout << "   --min-nodes N    minimum number of search nodes (0)" << endl;
+   cout << "   --max-nodes N    maximum number of search nodes, 0 for no maximum (10000000)" << endl;
+   cout << "   --workers N      number of puzzles searched at once, 0 for one per hardware thread (0)" << endl;
+   cout << "   --seed N         seed of the random choices (0)" << endl;
+   cout << "   --time-limit S   stop after that many seconds, 0 for no limit (0)" << endl;
+   cout << "   --output DIR     folder where the puzzles are written (generated)" << endl;
+}
+
+int main(int arg_count, char** arg_values)
+{
+   generator_options_t options;
+
+   try
+   {
+      for (int arg_index = 1; arg_index < arg_count; ++arg_index)
+      {
+         const string arg(arg_values[arg_index]);
+         const bool has_value = arg_index + 1 < arg_count;
+         if (arg == "--count" && has_value)
+            options.puzzles_count = stoul(arg_values[++arg_index]);
+         else if (arg == "--tiles" && has_value)
+            options.tiles_count = stoul(arg_values[++arg_index]);
+         else if (arg == "--shape" && has_value)
+            options.is_triangle = (string(arg_values[++arg_index]) != "any");
+         else if (arg == "--colors" && has_value)
+            options.colors_count = clamp<size_t>(stoul(arg_values[++arg_index]), 1, 2);
+         else if (arg == "--loops")
+            options.must_be_loops = true;
+         else if (arg == "--min-nodes" && has_value)
+            options.min_nodes = stoull(arg_values[++arg_index]);
+         else if (arg == "--max-nodes" && has_value)
+            options.max_nodes = stoull(arg_values[++arg_index]);
+         else if (arg == "--workers" && has_value)
+            options.workers_count = stoul(arg_values[++arg_index]);
+         else if (arg == "--seed" && has_value)
+            options.seed = stoull(arg_values[++arg_index]);
+         else if (arg == "--time-limit" && has_value)
+            options.time_limit = chrono::seconds(stoul(arg_values[++arg_index]));
+         else if (arg == "--output" && has_value)
+            options.output_folder = arg_values[++arg_index];
+         else
+         {
+            print_usage();
+            return 1;
+         }
+      }
+
+      if (options.workers_count <= 0)
+         options.workers_count = max<size_t>(thread::hardware_concurrency(), 1);
+
+      filesystem::create_directories(options.output_folder);
+
+      generator_state_t state;
+      vector<thread> workers;
+      vector<exception_ptr> errors(options.workers_count);
+      for (size_t i = 0; i < options.workers_count; ++i)
+      {
+         workers.emplace_back([i, &options, &state, &errors]()
+         {
+            try
+            {
+               generate_puzzles(i, options, state);
+            }
+            catch (...)
+            {
+               errors[i] = current_exception();
+               state.my_is_done = true;
+            }
+         });
+      }
+
+      for (thread& worker : workers)
+         worker.join();
+
+      for (const exception_ptr& error : errors)
+         if (error)
+            rethrow_exception(error);
+
+      const double seconds = chrono::duration<double>(clock_type::now() - state.my_start).count();
+      cout << "puzzles: " << state.my_accepted_count
+           << " out of " << state.my_candidates_count << " candidates"
+           << " in " << seconds << "s"
+           << " (" << size_t(seconds > 0. ? double(state.my_accepted_count) * 3600. / seconds : 0.) << " puzzles/hour)" << endl;
+      cout << "rejected: "
+           << state.my_no_solution_count << " without solution, "
+           << state.my_many_solutions_count << " with many solutions, "
+           << state.my_too_easy_count << " too easy, "
+           << state.my_too_hard_count << " too hard, "
+           << state.my_duplicates_count << " duplicates" << endl;
+      if (state.my_is_exhausted)
+         cout << "stopped: no new candidate was found in " << max_consecutive_duplicates << " tries" << endl;
+
+      return 0;
+   }
+   catch (const exception& ex)
+   {
+      cerr << ex.what() << endl;
+      return 1;
+   }
+}
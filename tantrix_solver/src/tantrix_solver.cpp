@@ -1,74 +1,417 @@
 #include "dak/tantrix/tantrix.h"
+#include "dak/tantrix/binary_solutions.h"
+#include "dak/tantrix/multi_query.h"
+#include "dak/tantrix/parse.h"
+#include "dak/tantrix/solutions_cache.h"
 #include "dak/tantrix/stream.h"
-#include "dak/solver/solve.h"
-#include "dak/utility/stream_progress.h"
+#include "dak/search/estimate.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/search/thread_pool.h"
+#include "dak/search/trace.h"
 #include "dak/utility/stopwatch.h"
 
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <optional>
+#include <sstream>
 
 using namespace std;
 using namespace dak::tantrix;
 using namespace dak::utility;
-using namespace dak::solver;
+using namespace dak::search;
+
+template <class PUZZLE>
+static void estimate_puzzle(const PUZZLE& a_puzzle)
+{
+   const estimate_t estimate = estimator_t<PUZZLE, dak::tantrix::solution_t>::estimate(a_puzzle, dak::tantrix::solution_t(a_puzzle));
+   cout << "estimated nodes: " << size_t(estimate.nodes_count) << endl;
+   cout << "estimated time: " << size_t(estimate.milliseconds) << " ms" << endl;
+}
+
+static void print_counters(const progress_counters_t& some_counters)
+{
+   cout << "nodes: " << some_counters.nodes_count()
+        << " (" << uint64_t(some_counters.nodes_per_second()) << " nodes/s), "
+        << "pruned: " << some_counters.prunes_count() << endl;
+   cout << "nodes per depth:";
+   for (const uint64_t count : some_counters.depth_histogram())
+      cout << " " << count;
+   cout << endl;
+}
+
+static void save_puzzle_solutions(const filesystem::path& a_puzzle_filename, const dak::tantrix::all_solutions_t& some_solutions, bool save_binary)
+{
+   filesystem::path solution_filename(a_puzzle_filename);
+   solution_filename.replace_extension(save_binary ? "solutions.bin" : "solutions.txt");
+   save_solutions(solution_filename, some_solutions, save_binary);
+}
+
+// Add the search statistics of a puzzle, as JSON, to the statistics of the run.
+static void add_statistics(vector<string>& some_statistics, const string& a_puzzle_name, const progress_counters_t& some_counters)
+{
+   ostringstream stream;
+   write_json(stream, some_counters);
+
+   string name;
+   for (const char c : a_puzzle_name)
+   {
+      if (c == '"' || c == '\\')
+         name += '\\';
+      name += c;
+   }
+
+   // Name the puzzle in the first member of the object.
+   string json = stream.str();
+   json.insert(2, "  \"puzzle\": \"" + name + "\",\n");
+   some_statistics.push_back(json);
+}
+
+// Write the statistics of the run as a JSON array.
+static void save_statistics(const filesystem::path& a_filename, const vector<string>& some_statistics)
+{
+   ofstream stream(a_filename);
+   stream << "[";
+   for (size_t i = 0; i < some_statistics.size(); ++i)
+      stream << (i ? ",\n" : "\n") << some_statistics[i];
+   stream << "\n]\n";
+}
+
+// Write the timeline of the solver threads in the Chrome trace-event format.
+static void save_trace(const filesystem::path& a_filename, const trace_recorder_t& a_trace)
+{
+   ofstream stream(a_filename);
+   a_trace.write_chrome_trace(stream);
+}
+
+// Error thrown by the progress to stop a search that takes too long.
+struct time_limit_error_t : runtime_error
+{
+   time_limit_error_t() : runtime_error("time limit reached") {}
+};
+
+// Progress that prints the number of nodes and stops the search after the time limit, if there is one.
+struct solver_progress_t : stream_search_progress_t
+{
+   solver_progress_t(ostream& a_stream, chrono::seconds a_time_limit)
+   : stream_search_progress_t(a_stream), my_time_limit(a_time_limit), my_start(chrono::steady_clock::now())
+   {
+   }
+
+   void update_progress(size_t a_total_count_so_far) override
+   {
+      stream_search_progress_t::update_progress(a_total_count_so_far);
+      if (my_time_limit.count() > 0 && chrono::steady_clock::now() - my_start > my_time_limit)
+         throw time_limit_error_t();
+   }
+
+private:
+   chrono::seconds                     my_time_limit;
+   chrono::steady_clock::time_point    my_start;
+};
+
+// Print the partial solution with the most tiles placed, then the longest line of the first color.
+static void print_best_partial(const best_partial_t<dak::tantrix::solution_t>& a_best_partial, const puzzle_t& a_puzzle)
+{
+   if (!a_best_partial.solution())
+   {
+      cout << "best partial solution: none" << endl;
+      return;
+   }
+
+   const dak::tantrix::solution_t& solution = *a_best_partial.solution();
+   cout << "best partial solution: " << solution.tiles_count() << " of " << a_puzzle.initial_tiles().size() << " tiles placed";
+   if (a_puzzle.line_colors().size() > 0)
+      cout << ", longest " << a_puzzle.line_colors()[0] << " line: " << a_best_partial.rank().score << " tiles";
+   cout << endl;
+   cout << solution << endl;
+}
+
+// Parse the name of a fill order of triangle puzzles.
+static triangle_puzzle_t::fill_order_t parse_fill_order(const string& a_name)
+{
+   if (a_name == "rows")
+      return triangle_puzzle_t::fill_order_t::rows;
+   if (a_name == "spiral")
+      return triangle_puzzle_t::fill_order_t::spiral;
+   if (a_name == "edge")
+      return triangle_puzzle_t::fill_order_t::edge_first;
+   if (a_name == "auto")
+      return triangle_puzzle_t::fill_order_t::automatic;
+   throw runtime_error("unknown fill order " + a_name + ", expected rows, spiral, edge or auto");
+}
+
+static const char* fill_order_name(triangle_puzzle_t::fill_order_t a_fill_order)
+{
+   switch (a_fill_order)
+   {
+      case triangle_puzzle_t::fill_order_t::spiral:      return "spiral";
+      case triangle_puzzle_t::fill_order_t::edge_first:  return "edge";
+      case triangle_puzzle_t::fill_order_t::automatic:   return "auto";
+      default:                                           return "rows";
+   }
+}
+
+// Load a puzzle, filling triangle puzzles in the given order.
+static std::shared_ptr<puzzle_t> load_puzzle(const filesystem::path& a_filename, triangle_puzzle_t::fill_order_t a_fill_order)
+{
+   std::shared_ptr<puzzle_t> puzzle = dak::tantrix::load_puzzle(a_filename);
+   if (!std::dynamic_pointer_cast<triangle_puzzle_t>(puzzle) || a_fill_order == triangle_puzzle_t::fill_order_t::rows)
+      return puzzle;
+
+   auto triangle = std::make_shared<triangle_puzzle_t>(puzzle->initial_tiles(), puzzle->line_colors(), puzzle->must_be_loops(), puzzle->holes_count(), a_fill_order);
+   cout << "fill order: " << fill_order_name(triangle->fill_order()) << endl;
+   return triangle;
+}
+
+// Solve the puzzle, unless its solutions are in the cache.
+//
+// With best effort, the best partial solution is printed when the puzzle
+// has no solution or when the search is stopped by the time limit.
+static dak::tantrix::all_solutions_t solve_puzzle(const std::shared_ptr<puzzle_t>& a_puzzle, const string& a_puzzle_name, optional<solutions_cache_t>& a_solutions_cache, thread_pool_t& a_thread_pool, size_t transposition_megabytes, vector<string>& some_statistics, trace_recorder_t* a_trace,
+                                                  chrono::seconds a_time_limit, bool best_effort)
+{
+   if (a_solutions_cache)
+   {
+      if (auto cached_solutions = a_solutions_cache->find(*a_puzzle))
+      {
+         cout << "solutions: " << cached_solutions->size() << " (cached)" << endl;
+         return std::move(*cached_solutions);
+      }
+   }
+
+   string elapsed_time;
+   stopwatch_t stopwatch(elapsed_time);
+
+   solver_progress_t progress(cout, a_time_limit);
+   progress.set_trace(a_trace);
+   best_partial_t<dak::tantrix::solution_t> best_partial;
+   if (best_effort)
+      progress.set_best_partial(&best_partial);
+   solver_t<triangle_puzzle_t, dak::tantrix::solution_t>::all_solutions_t solutions;
+   try
+   {
+      if (auto tri = std::dynamic_pointer_cast<triangle_puzzle_t>(a_puzzle)) {
+         solutions = solver_t<triangle_puzzle_t, dak::tantrix::solution_t>::solve(*tri, dak::tantrix::solution_t(*tri), progress, a_thread_pool);
+      }
+      if (auto mask = std::dynamic_pointer_cast<mask_puzzle_t>(a_puzzle)) {
+         solutions = solver_t<mask_puzzle_t, dak::tantrix::solution_t>::solve(*mask, dak::tantrix::solution_t(*mask), progress, a_thread_pool);
+      }
+      if (auto shape = std::dynamic_pointer_cast<any_shape_puzzle_t>(a_puzzle)) {
+         shape->use_transposition_table(transposition_megabytes * 1024 * 1024);
+         solutions = solver_t<any_shape_puzzle_t, dak::tantrix::solution_t>::solve(*shape, dak::tantrix::solution_t(*shape), progress, a_thread_pool);
+      }
+   }
+   catch (const time_limit_error_t&)
+   {
+      cout << "\n";
+      if (best_effort)
+         print_best_partial(best_partial, *a_puzzle);
+      throw;
+   }
+
+   stopwatch.stop();
+
+   cout << "\n";
+   cout << "time: " << elapsed_time << endl;
+   cout << "solutions: " << solutions.size() << endl;
+   print_counters(progress.counters());
+   add_statistics(some_statistics, a_puzzle_name, progress.counters());
+   if (best_effort && solutions.size() <= 0)
+      print_best_partial(best_partial, *a_puzzle);
+
+   if (auto shape = std::dynamic_pointer_cast<any_shape_puzzle_t>(a_puzzle)) {
+      if (const auto& table = shape->transposition_table()) {
+         cout << "transpositions: " << table->hits_count() << " hits in " << table->lookups_count() << " lookups ("
+              << size_t(table->hit_rate() * 100.) << "%), " << table->evictions_count() << " evictions" << endl;
+      }
+   }
+
+   if (a_solutions_cache)
+      a_solutions_cache->store(*a_puzzle, solutions);
+
+   return solutions;
+}
 
 int main(int arg_count, char** arg_values)
 {
    using clock = chrono::steady_clock;
    using path = filesystem::path;
-    
+
+   bool estimate_only = false;
+   bool multi_query = false;
+   bool save_binary = false;
+   bool convert_to_binary = false;
+   bool convert_to_text = false;
+   size_t transposition_megabytes = 0;
+   optional<solutions_cache_t> solutions_cache;
+   path statistics_filename;
+   vector<string> statistics;
+   path trace_filename;
+   optional<trace_recorder_t> trace;
+   triangle_puzzle_t::fill_order_t fill_order = triangle_puzzle_t::fill_order_t::rows;
+   chrono::seconds time_limit(0);
+   bool best_effort = false;
+   vector<path> filenames;
    for (int arg_index = 1; arg_index < arg_count; ++arg_index)
    {
-      try
-      {
-         const path filename(arg_values[arg_index]);
-         cout << "solving puzzle: " << filename.filename() << endl;
+      const string arg(arg_values[arg_index]);
+      if (arg == "--estimate")
+         estimate_only = true;
+      else if (arg == "--transposition-table" && arg_index + 1 < arg_count)
+         transposition_megabytes = stoul(arg_values[++arg_index]);
+      else if (arg == "--cache" && arg_index + 1 < arg_count)
+         solutions_cache.emplace(arg_values[++arg_index]);
+      else if (arg == "--stats" && arg_index + 1 < arg_count)
+         statistics_filename = arg_values[++arg_index];
+      else if (arg == "--trace" && arg_index + 1 < arg_count)
+         trace_filename = arg_values[++arg_index];
+      else if (arg == "--fill-order" && arg_index + 1 < arg_count)
+         fill_order = parse_fill_order(arg_values[++arg_index]);
+      else if (arg == "--time-limit" && arg_index + 1 < arg_count)
+         time_limit = chrono::seconds(stoul(arg_values[++arg_index]));
+      else if (arg == "--best-effort")
+         best_effort = true;
+      else if (arg == "--multi-query")
+         multi_query = true;
+      else if (arg == "--binary")
+         save_binary = true;
+      else if (arg == "--to-binary")
+         convert_to_binary = true;
+      else if (arg == "--to-text")
+         convert_to_text = true;
+      else
+         filenames.emplace_back(arg);
+   }
 
-         std::shared_ptr<puzzle_t> puzzle;
+   // Convert solutions files between the text and binary formats instead of solving.
+   if (convert_to_binary || convert_to_text)
+   {
+      for (const path& filename : filenames)
+      {
+         try
          {
-            ifstream puzzle_stream(filename);
-            puzzle_stream >> puzzle;
+            path converted_filename(filename);
+            converted_filename.replace_extension(convert_to_binary ? "bin" : "txt");
+            if (convert_to_binary)
+               convert_text_to_binary_solutions(filename, converted_filename);
+            else
+               convert_binary_to_text_solutions(filename, converted_filename);
+            cout << "converted: " << filename.filename() << " to " << converted_filename.filename() << endl;
          }
+         catch (exception& ex)
+         {
+            cout << "Error: " << ex.what() << endl;
+         }
+      }
+      return 0;
+   }
+    
+   thread_pool_t thread_pool;
 
-         if (!puzzle)
+   if (!trace_filename.empty())
+      trace.emplace();
+
+   // Solve the puzzles that only differ by their number of holes with a single search.
+   if (multi_query && !estimate_only)
+   {
+      vector<path> puzzle_filenames;
+      vector<std::shared_ptr<puzzle_t>> puzzles;
+      for (const path& filename : filenames)
+      {
+         try
          {
-            cout << "Invalid puzzle file: " << filename.filename() << endl;
-            continue;
+            std::shared_ptr<puzzle_t> puzzle = load_puzzle(filename, fill_order);
+            if (!puzzle)
+            {
+               cout << "Invalid puzzle file: " << filename.filename() << endl;
+               continue;
+            }
+            puzzle_filenames.push_back(filename);
+            puzzles.push_back(puzzle);
          }
+         catch (exception& ex)
+         {
+            cout << "Error: " << ex.what() << endl;
+         }
+      }
 
-         cout << puzzle << endl;
+      for (const query_group_t& group : group_queries(puzzles))
+      {
+         try
+         {
+            cout << "solving puzzles:";
+            for (const size_t index : group.query_indices)
+               cout << " " << puzzle_filenames[index].filename();
+            cout << endl;
 
-         string elapsed_time;
-         stopwatch_t stopwatch(elapsed_time);
+            cout << group.shared_puzzle << endl;
 
-         stream_progress_t progress(cout);
-         solver_t<triangle_puzzle_t, dak::tantrix::solution_t>::all_solutions_t solutions;
-         if (auto tri = std::dynamic_pointer_cast<triangle_puzzle_t>(puzzle)) {
-            solutions = solver_t<triangle_puzzle_t, dak::tantrix::solution_t>::solve(*tri, dak::tantrix::solution_t(*tri), progress);
+            const dak::tantrix::all_solutions_t shared_solutions = solve_puzzle(group.shared_puzzle, puzzle_filenames[group.query_indices[0]].filename().string(), solutions_cache, thread_pool, transposition_megabytes, statistics, trace ? &*trace : nullptr, time_limit, best_effort);
+            const vector<dak::tantrix::all_solutions_t> solutions = split_solutions(group, puzzles, shared_solutions);
+            for (size_t i = 0; i < group.query_indices.size(); ++i)
+            {
+               const size_t index = group.query_indices[i];
+               cout << "solutions: " << solutions[i].size() << " for " << puzzle_filenames[index].filename() << endl;
+               if (solutions_cache)
+                  solutions_cache->store(*puzzles[index], solutions[i]);
+               save_puzzle_solutions(puzzle_filenames[index], solutions[i], save_binary);
+            }
          }
-         if (auto shape = std::dynamic_pointer_cast<any_shape_puzzle_t>(puzzle)) {
-            solutions = solver_t<any_shape_puzzle_t, dak::tantrix::solution_t>::solve(*shape, dak::tantrix::solution_t(*shape), progress);
+         catch (exception& ex)
+         {
+            cout << "Error: " << ex.what() << endl;
          }
+      }
 
-         stopwatch.stop();
+      if (!statistics_filename.empty())
+         save_statistics(statistics_filename, statistics);
+      if (trace)
+         save_trace(trace_filename, *trace);
+      return 0;
+   }
 
-         cout << "\n";
-         cout << "time: " << elapsed_time << endl;
-         cout << "solutions: " << solutions.size() << endl;
+   for (const path& filename : filenames)
+   {
+      try
+      {
+         cout << "solving puzzle: " << filename.filename() << endl;
+
+         std::shared_ptr<puzzle_t> puzzle = load_puzzle(filename, fill_order);
+
+         if (!puzzle)
+         {
+            cout << "Invalid puzzle file: " << filename.filename() << endl;
+            continue;
+         }
 
-         path solution_filename(filename);
-         solution_filename.replace_extension("solutions.txt");
+         cout << puzzle << endl;
 
-         ofstream solution_stream(solution_filename);
-         for (const auto& solution : solutions) {
-            solution_stream << solution << endl;
+         if (estimate_only)
+         {
+            if (auto tri = std::dynamic_pointer_cast<triangle_puzzle_t>(puzzle))
+               estimate_puzzle(*tri);
+            if (auto mask = std::dynamic_pointer_cast<mask_puzzle_t>(puzzle))
+               estimate_puzzle(*mask);
+            if (auto shape = std::dynamic_pointer_cast<any_shape_puzzle_t>(puzzle))
+               estimate_puzzle(*shape);
+            continue;
          }
+
+         const dak::tantrix::all_solutions_t solutions = solve_puzzle(puzzle, filename.filename().string(), solutions_cache, thread_pool, transposition_megabytes, statistics, trace ? &*trace : nullptr, time_limit, best_effort);
+         save_puzzle_solutions(filename, solutions, save_binary);
       }
       catch (exception& ex)
       {
          cout << "Error: " << ex.what() << endl;
       }
    }
+
+   if (!statistics_filename.empty())
+      save_statistics(statistics_filename, statistics);
+   if (trace)
+      save_trace(trace_filename, *trace);
 }
 
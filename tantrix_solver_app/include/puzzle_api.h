@@ -4,6 +4,8 @@
 #include <dak/solver/solution.h>
 #include <dak/solver/solve.h>
 
+#include <dak/search/progress.h>
+
 #include <dak/utility/progress.h>
 #include <dak/utility/stopwatch.h>
 
@@ -17,13 +19,13 @@ class QGraphicsView;
 
 namespace dak::tantrix_solver_app
 {
-   struct puzzle_api_t : protected utility::progress_t
+   struct puzzle_api_t : protected search::search_progress_t
    {
       using ptr_t = std::shared_ptr<puzzle_api_t>;
       using all_solutions_t = std::vector<solver::solution_t::ptr_t>;
 
       puzzle_api_t()
-      : progress_t(10000), my_solving_stopwatch(my_solving_time_buffer)
+      : search_progress_t(10000), my_solving_stopwatch(my_solving_time_buffer)
       {}
 
       virtual ~puzzle_api_t() = default;
@@ -35,7 +37,8 @@ namespace dak::tantrix_solver_app
       virtual all_solutions_t get_solutions() const = 0;
 
       std::string get_solving_time() { my_solving_stopwatch.elapsed(); return my_solving_time_buffer; }
-      size_t get_solving_attempts() const { return my_solving_attempts.load(); }
+      size_t get_solving_attempts() const { return size_t(counters().nodes_count()); }
+      size_t get_solving_speed() const { return size_t(counters().nodes_per_second()); }
 
       // Function to convert to and from text to allow the user to edit the puzzle.
       virtual solver::problem_t::ptr_t convert_text_to_puzzle(const std::string& a_puzzle_desc) = 0;
@@ -73,13 +76,12 @@ namespace dak::tantrix_solver_app
          const std::string& a_selected_tile) = 0;
 
       // Asynchronous puzzle solving update from progress_t interface.
-      void update_progress(size_t a_total_count_so_far) override
+      // The attempts are read directly from the search counters when displayed.
+      void update_progress(size_t /*a_total_count_so_far*/) override
       {
-         my_solving_attempts = a_total_count_so_far;
       }
 
    protected:
-      std::atomic<size_t>       my_solving_attempts = 0;
       dak::utility::stopwatch_t my_solving_stopwatch;
       std::string               my_solving_time_buffer;
    };
@@ -5,7 +5,10 @@
 #include <dak/six_eight/puzzle.h>
 #include <dak/six_eight/solution.h>
 
+#include <dak/search/thread_pool.h>
+
 #include <future>
+#include <memory>
 
 namespace dak::tantrix_solver_app
 {
@@ -45,5 +48,9 @@ namespace dak::tantrix_solver_app
    private:
       std::future<std::set<six_eight::solution_t>> my_async_solving;
       std::set<six_eight::solution_t>              my_solutions;
+      std::shared_ptr<const six_eight::puzzle_t>   my_solving_puzzle;
+
+      // Declared last so it waits for the solving to end before anything else is destroyed.
+      search::thread_pool_t                        my_thread_pool;
    };
 }
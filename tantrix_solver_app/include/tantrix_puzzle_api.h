@@ -4,8 +4,12 @@
 
 #include <dak/tantrix/puzzle.h>
 #include <dak/tantrix/solution.h>
+#include <dak/tantrix/solutions_cache.h>
+
+#include <dak/search/thread_pool.h>
 
 #include <future>
+#include <memory>
 
 namespace dak::tantrix_solver_app
 {
@@ -45,5 +49,11 @@ namespace dak::tantrix_solver_app
    private:
       std::future<std::set<tantrix::solution_t>> my_async_solving;
       std::set<tantrix::solution_t>              my_solutions;
+      std::shared_ptr<const tantrix::puzzle_t>   my_solving_puzzle;
+      bool                                       my_is_solving_cached = false;
+      tantrix::solutions_cache_t                 my_solutions_cache = tantrix::solutions_cache_t(tantrix::solutions_cache_t::default_directory());
+
+      // Declared last so it waits for the solving to end before anything else is destroyed.
+      search::thread_pool_t                      my_thread_pool;
    };
 }
@@ -310,6 +310,8 @@ namespace dak::tantrix_solver_app
       for (const auto& entry : std::filesystem::directory_iterator(puzzles_folder)) {
          if (entry.path().string().find(".solutions.txt") != std::string::npos)
             continue;
+         if (entry.path().string().find(".solutions.bin") != std::string::npos)
+            continue;
          
          for (const auto& puzzle_api : my_puzzle_apis) {
             try {
@@ -464,7 +466,7 @@ namespace dak::tantrix_solver_app
 
    void main_window_t::save_solutions()
    {
-      static constexpr char solutions_file_types[] = "Solutions Text files (*.solutions.txt);;All files (*.*)";
+      static constexpr char solutions_file_types[] = "Solutions Text files (*.solutions.txt);;Solutions Binary files (*.solutions.bin);;All files (*.*)";
 
       try
       {
@@ -490,7 +492,7 @@ namespace dak::tantrix_solver_app
 
    void main_window_t::load_solutions()
    {
-      static constexpr char solutions_file_types[] = "Solutions Text files (*.solutions.txt);;All files (*.*)";
+      static constexpr char solutions_file_types[] = "Solutions Text files (*.solutions.txt);;Solutions Binary files (*.solutions.bin);;All files (*.*)";
 
       try
       {
@@ -605,6 +607,12 @@ namespace dak::tantrix_solver_app
          else
             stream << "Attempts: " << (solving_attempts / (1000 * 1000)) << " millions";
 
+         const size_t solving_speed = my_active_api->get_solving_speed();
+         if (solving_speed >= 2 * 1000 * 1000)
+            stream << " (" << (solving_speed / (1000 * 1000)) << " millions/s)";
+         else if (solving_speed >= 2 * 1000)
+            stream << " (" << (solving_speed / 1000) << " thousands/s)";
+
          my_solving_attempts_label->setText(stream.str().c_str());
          if (!my_solving_attempts_label->isVisible())
             my_solving_attempts_label->show();
@@ -2,7 +2,9 @@
 
 #include <dak/solver/problem.h>
 #include <dak/solver/solution.h>
-#include <dak/solver/solve.h>
+#include <dak/search/solve.h>
+#include <dak/six_eight/format.h>
+#include <dak/six_eight/parse.h>
 #include <dak/six_eight/solution.h>
 #include <dak/six_eight/stream.h>
 #include <dak/six_eight/puzzle.h>
@@ -21,20 +23,16 @@ namespace dak::tantrix_solver_app
       if (!puzzle)
          return false;
 
+      // The previous puzzle must remain valid until its solving is done.
+      if (my_async_solving.valid())
+         my_async_solving.wait();
+
       stop_progress(false);
-      my_solving_attempts = 0;
+      counters().start_counting();
       my_solving_stopwatch.start();
-      my_async_solving = std::async(std::launch::async, [self = this, puzzle = puzzle]()
-      {
-         try
-         {
-            return solver::solver_t<six_eight::puzzle_t, six_eight::solution_t>::solve(*puzzle, {}, *self);
-         }
-         catch (const std::exception&)
-         {
-         }
-         return std::set<six_eight::solution_t>();
-      });
+
+      my_solving_puzzle = puzzle;
+      my_async_solving = search::solver_t<six_eight::puzzle_t, six_eight::solution_t>::solve_async(*puzzle, {}, *this, my_thread_pool);
       return true;
    }
 
@@ -51,7 +49,14 @@ namespace dak::tantrix_solver_app
       if (my_async_solving.wait_for(1us) != future_status::ready)
          return false;
 
-      my_solutions = my_async_solving.get();
+      try
+      {
+         my_solutions = my_async_solving.get();
+      }
+      catch (const std::exception&)
+      {
+         my_solutions.clear();
+      }
       return true;
    }
 
@@ -63,29 +68,9 @@ namespace dak::tantrix_solver_app
       return solver_solutions;
    }
 
-   static std::shared_ptr<six_eight::puzzle_t> load_six_eight_puzzle(std::istream& a_stream)
-   {
-      auto puzzle = std::make_shared<six_eight::puzzle_t>();
-      a_stream >> *puzzle;
-      return puzzle;
-   }
-
    solver::problem_t::ptr_t six_eight_puzzle_api_t::convert_text_to_puzzle(const std::string& a_puzzle_desc)
    {
-      std::vector<six_eight::tile_t> tiles;
-      {
-         std::istringstream stream(a_puzzle_desc);
-         for (int i = 0; i < 8; ++i) {
-            six_eight::tile_t::id_t tile_id;
-            stream >> tile_id;
-            tiles.emplace_back(six_eight::tile_t(tile_id));
-         }
-
-         if (!stream)
-            return {};
-      }
-
-      return std::make_shared<six_eight::puzzle_t>(tiles);
+      return std::make_shared<six_eight::puzzle_t>(six_eight::parse_puzzle(a_puzzle_desc));
    }
 
    std::string six_eight_puzzle_api_t::convert_puzzle_to_text(const solver::problem_t::ptr_t & a_puzzle)
@@ -99,52 +84,28 @@ namespace dak::tantrix_solver_app
       return stream.str();
    }
 
-   static std::shared_ptr<six_eight::puzzle_t> load_six_eight_puzzle(const std::filesystem::path& a_path)
-   {
-      if (a_path.empty())
-         return{};
-
-      std::ifstream puzzle_stream(a_path);
-      return load_six_eight_puzzle(puzzle_stream);
-   }
-
-   static std::vector<std::string> load_six_eight_puzzle_descriptions(std::istream& a_stream)
-   {
-      std::vector<std::string> puzzles;
-      while (a_stream) {
-         six_eight::puzzle_t puzzle;
-         a_stream >> puzzle;
-         if (a_stream) {
-            std::ostringstream stream;
-            for (const auto& tile : puzzle.initial_tiles())
-               stream <<tile.id() << " ";
-            puzzles.emplace_back(stream.str());
-         }
-      }
-      return puzzles;
-   }
-
    std::vector<std::pair<std::string, std::string>> six_eight_puzzle_api_t::load_puzzle_descriptions(const std::filesystem::path& a_path)
    {
       if (a_path.empty())
          return{};
 
-      std::ifstream puzzle_stream(a_path);
-      auto descriptions = load_six_eight_puzzle_descriptions(puzzle_stream);
       std::vector<std::pair<std::string, std::string>> label_and_descs;
-      for (const auto& desc : descriptions)
-         label_and_descs.emplace_back(std::string("6x8 ") + desc, std::string("6x8 ") + desc);
+      for (const auto& puzzle : six_eight::load_puzzles(a_path)) {
+         std::ostringstream stream;
+         stream << "6x8 ";
+         for (const auto& tile : puzzle.initial_tiles())
+            stream << tile.id() << " ";
+         label_and_descs.emplace_back(stream.str(), stream.str());
+      }
       return label_and_descs;
    }
 
    solver::problem_t::ptr_t six_eight_puzzle_api_t::load_puzzle_from_description(const std::string& a_desc)
    {
-      std::istringstream stream(a_desc);
-      std::string prefix;
-      stream >> prefix;
-      if (prefix != "6x8")
+      static constexpr std::string_view prefix = "6x8 ";
+      if (!a_desc.starts_with(prefix))
          return {};
-      return load_six_eight_puzzle(stream);
+      return std::make_shared<six_eight::puzzle_t>(six_eight::parse_puzzle(std::string_view(a_desc).substr(prefix.size())));
    }
 
    static void save_six_eight_puzzle(std::ostream& a_stream, const solver::problem_t::ptr_t& a_puzzle)
@@ -167,13 +128,15 @@ namespace dak::tantrix_solver_app
          return;
 
       std::ofstream solutions_stream(a_path);
+      search::text_writer_t writer(solutions_stream);
 
       for (const auto& solution : some_solutions) {
          auto puzzle_solution = std::dynamic_pointer_cast<six_eight::solution_t>(solution);
          if (!puzzle_solution)
             continue;
 
-         solutions_stream << *puzzle_solution << std::endl;
+         six_eight::write_solution(writer, *puzzle_solution);
+         writer.write('\n');
       }
    }
 
@@ -184,9 +147,7 @@ namespace dak::tantrix_solver_app
 
       all_solutions_t solver_solutions;
 
-      six_eight::all_solutions_t solutions;
-      std::ifstream solutions_stream(a_path);
-      solutions_stream >> solutions;
+      const six_eight::all_solutions_t solutions = six_eight::load_solutions(a_path);
       for (auto& solution : solutions)
             solver_solutions.push_back(std::make_shared<six_eight::solution_t>(solution));
 
@@ -2,11 +2,14 @@
 
 #include <dak/solver/problem.h>
 #include <dak/solver/solution.h>
-#include <dak/solver/solve.h>
+#include <dak/search/solve.h>
+#include <dak/tantrix/binary_solutions.h>
+#include <dak/tantrix/parse.h>
 #include <dak/tantrix/solution.h>
 #include <dak/tantrix/stream.h>
 #include <dak/tantrix/triangle_puzzle.h>
 #include <dak/tantrix/any_shape_puzzle.h>
+#include <dak/tantrix/mask_puzzle.h>
 
 #include <filesystem>
 #include <fstream>
@@ -25,29 +28,47 @@ namespace dak::tantrix_solver_app
       if (!puzzle)
          return false;
 
+      // The previous puzzle must remain valid until its solving is done.
+      if (my_async_solving.valid())
+         my_async_solving.wait();
+
       stop_progress(false);
-      my_solving_attempts = 0;
+      counters().start_counting();
       my_solving_stopwatch.start();
-      my_async_solving = std::async(std::launch::async, [self = this, puzzle = puzzle]()
-      {
-         try
-         {
-            if (auto triangle_puzzle = std::dynamic_pointer_cast<const tantrix::triangle_puzzle_t>(puzzle)) {
-               tantrix::solution_t initial_solution(*triangle_puzzle);
-               return solver::solver_t<tantrix::triangle_puzzle_t, tantrix::solution_t>::solve(*triangle_puzzle, initial_solution, *self);
-            }
-
-            if (auto any_shape_puzzle = std::dynamic_pointer_cast<const tantrix::any_shape_puzzle_t>(puzzle)) {
-               tantrix::solution_t initial_solution(*any_shape_puzzle);
-               return solver::solver_t<tantrix::any_shape_puzzle_t, tantrix::solution_t>::solve(*any_shape_puzzle, initial_solution, *self);
-            }
-         }
-         catch (const std::exception&)
-         {
-         }
-         return std::set<tantrix::solution_t>();
-      });
-      return true;
+
+      my_solving_puzzle = puzzle;
+
+      // Solutions already found by this version of the solver are used directly.
+      if (auto cached_solutions = my_solutions_cache.find(*puzzle)) {
+         std::promise<std::set<tantrix::solution_t>> cached_solving;
+         cached_solving.set_value(std::move(*cached_solutions));
+         my_async_solving = cached_solving.get_future();
+         my_is_solving_cached = true;
+         counters().stop_counting();
+         return true;
+      }
+
+      my_is_solving_cached = false;
+
+      if (auto triangle_puzzle = std::dynamic_pointer_cast<const tantrix::triangle_puzzle_t>(puzzle)) {
+         tantrix::solution_t initial_solution(*triangle_puzzle);
+         my_async_solving = search::solver_t<tantrix::triangle_puzzle_t, tantrix::solution_t>::solve_async(*triangle_puzzle, initial_solution, *this, my_thread_pool);
+         return true;
+      }
+
+      if (auto mask_puzzle = std::dynamic_pointer_cast<const tantrix::mask_puzzle_t>(puzzle)) {
+         tantrix::solution_t initial_solution(*mask_puzzle);
+         my_async_solving = search::solver_t<tantrix::mask_puzzle_t, tantrix::solution_t>::solve_async(*mask_puzzle, initial_solution, *this, my_thread_pool);
+         return true;
+      }
+
+      if (auto any_shape_puzzle = std::dynamic_pointer_cast<const tantrix::any_shape_puzzle_t>(puzzle)) {
+         tantrix::solution_t initial_solution(*any_shape_puzzle);
+         my_async_solving = search::solver_t<tantrix::any_shape_puzzle_t, tantrix::solution_t>::solve_async(*any_shape_puzzle, initial_solution, *this, my_thread_pool);
+         return true;
+      }
+
+      return false;
    }
 
    void tantrix_puzzle_api_t::stop_solving()
@@ -63,7 +84,16 @@ namespace dak::tantrix_solver_app
       if (my_async_solving.wait_for(1us) != future_status::ready)
          return false;
 
-      my_solutions = my_async_solving.get();
+      try
+      {
+         my_solutions = my_async_solving.get();
+         if (!my_is_solving_cached && my_solving_puzzle)
+            my_solutions_cache.store(*my_solving_puzzle, my_solutions);
+      }
+      catch (const std::exception&)
+      {
+         my_solutions.clear();
+      }
       return true;
    }
 
@@ -74,17 +104,9 @@ namespace dak::tantrix_solver_app
          solver_solutions.push_back(std::make_shared<tantrix::solution_t>(solution));
       return solver_solutions;
    }
-   static std::shared_ptr<tantrix::puzzle_t> load_tantrix_puzzle(std::istream& a_stream)
-   {
-      std::shared_ptr<tantrix::puzzle_t> puzzle;
-      a_stream >> puzzle;
-      return puzzle;
-   }
-
    solver::problem_t::ptr_t tantrix_puzzle_api_t::convert_text_to_puzzle(const std::string& a_puzzle_desc)
    {
-      std::istringstream stream(a_puzzle_desc);
-      return load_tantrix_puzzle(stream);
+      return tantrix::parse_puzzle(a_puzzle_desc);
    }
 
    std::string tantrix_puzzle_api_t::convert_puzzle_to_text(const solver::problem_t::ptr_t& a_puzzle)
@@ -102,8 +124,7 @@ namespace dak::tantrix_solver_app
       if (a_path.empty())
          return {};
 
-      std::ifstream puzzle_stream(a_path);
-      return load_tantrix_puzzle(puzzle_stream);
+      return tantrix::load_puzzle(a_path);
    }
 
    std::vector<std::pair<std::string, std::string>> tantrix_puzzle_api_t::load_puzzle_descriptions(const std::filesystem::path& a_path)
@@ -138,14 +159,17 @@ namespace dak::tantrix_solver_app
       if (a_path.empty())
          return;
 
-      std::ofstream solutions_stream(a_path);
-
+      tantrix::all_solutions_t solutions;
       for (const auto& solution : some_solutions) {
          auto puzzle_solution = std::dynamic_pointer_cast<tantrix::solution_t>(solution);
          if (!puzzle_solution)
             continue;
-         solutions_stream << *puzzle_solution << std::endl;
+         solutions.insert(*puzzle_solution);
       }
+
+      // Always write the file, even without solutions, so an older file is not reloaded later.
+      const bool is_binary = (a_path.extension() == ".bin");
+      tantrix::save_solutions(a_path, solutions, is_binary);
    }
 
    tantrix_puzzle_api_t::all_solutions_t tantrix_puzzle_api_t::load_solutions(const std::filesystem::path& a_path)
@@ -155,9 +179,7 @@ namespace dak::tantrix_solver_app
 
       all_solutions_t solver_solutions;
 
-      tantrix::all_solutions_t solutions;
-      std::ifstream solutions_stream(a_path);
-      solutions_stream >> solutions;
+      const tantrix::all_solutions_t solutions = tantrix::load_solutions(a_path);
       for (auto& solution : solutions)
             solver_solutions.push_back(std::make_shared<tantrix::solution_t>(solution));
 
@@ -199,6 +221,9 @@ namespace dak::tantrix_solver_app
       if (std::dynamic_pointer_cast<tantrix::triangle_puzzle_t>(puzzle))
          description.emplace_back("Must be a triangle");
 
+      if (std::dynamic_pointer_cast<tantrix::mask_puzzle_t>(puzzle))
+         description.emplace_back("Must fill the mask");
+
       if (puzzle->holes_count().has_value())
       {
          std::ostringstream stream;
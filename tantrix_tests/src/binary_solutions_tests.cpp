@@ -0,0 +1,180 @@
+#include "dak/tantrix/binary_solutions.h"
+#include "dak/tantrix_tests/helpers.h"
+
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::tantrix;
+
+namespace dak::tantrix::tests
+{
+	TEST_CLASS(binary_solutions_tests)
+	{
+	public:
+
+		TEST_METHOD(write_binary_solutions_size)
+		{
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(0, 0));
+			sol.add_tile(tile_t(8).rotate(2), position_t(1, 0));
+
+			all_solutions_t solutions;
+			solutions.insert(sol);
+
+			std::ostringstream stream;
+			write_binary_solutions(stream, solutions);
+			Assert::AreEqual<size_t>(sizeof(binary_solutions_header_t) + 2 * binary_part_size, stream.str().size());
+			Assert::AreEqual(std::string("TXSB"), stream.str().substr(0, 4));
+		}
+
+		TEST_METHOD(write_binary_solutions_mismatched_tiles_count)
+		{
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(0, 0));
+
+			solution_t other({});
+			other.add_tile(tile_t(7), position_t(0, 0));
+			other.add_tile(tile_t(8), position_t(1, 0));
+
+			all_solutions_t solutions;
+			solutions.insert(sol);
+			solutions.insert(other);
+
+			std::ostringstream stream;
+			Assert::ExpectException<std::runtime_error>([&]() { write_binary_solutions(stream, solutions); });
+		}
+
+		TEST_METHOD(binary_solutions_round_trip)
+		{
+			all_solutions_t solutions;
+			for (int i = 0; i < 6; ++i)
+			{
+				solution_t sol({});
+				sol.add_tile(tile_t(1 + i).rotate(i), position_t(-31, 31 - i));
+				sol.add_tile(tile_t(20 + i).rotate(5 - i), position_t(i, -32));
+				sol.add_tile(tile_t(56 - i), position_t(0, i));
+				solutions.insert(sol);
+			}
+
+			const std::filesystem::path text_path = std::filesystem::temp_directory_path() / "binary_solutions_tests.solutions.txt";
+			const std::filesystem::path binary_path = std::filesystem::temp_directory_path() / "binary_solutions_tests.solutions.bin";
+			save_solutions(binary_path, solutions, true);
+			Assert::IsTrue(is_binary_solutions_file(binary_path));
+
+			{
+				mapped_solutions_t mapped(binary_path);
+				Assert::AreEqual(solutions.size(), mapped.size());
+				Assert::AreEqual<size_t>(3, mapped.tiles_count());
+
+				size_t index = 0;
+				for (const solution_t& sol : solutions)
+				{
+					const solution_t loaded = mapped.solution(index++);
+					Assert::IsTrue(sol.is_identical(loaded) == std::strong_ordering::equal);
+				}
+			}
+
+			convert_binary_to_text_solutions(binary_path, text_path);
+			Assert::IsFalse(is_binary_solutions_file(text_path));
+
+			const all_solutions_t loaded = load_solutions(text_path);
+			Assert::AreEqual(solutions.size(), loaded.size());
+			auto loaded_iter = loaded.begin();
+			for (const solution_t& sol : solutions)
+				Assert::IsTrue(sol.is_identical(*loaded_iter++) == std::strong_ordering::equal);
+
+			std::filesystem::remove(text_path);
+			std::filesystem::remove(binary_path);
+		}
+
+		TEST_METHOD(save_no_solutions_replaces_file)
+		{
+			all_solutions_t solutions;
+			solution_t sol({});
+			sol.add_tile(tile_t(1), position_t(0, 0));
+			solutions.insert(sol);
+
+			for (const bool is_binary : { false, true })
+			{
+				const std::filesystem::path path = std::filesystem::temp_directory_path() / "binary_solutions_tests.empty.solutions";
+				save_solutions(path, solutions, is_binary);
+				Assert::AreEqual<size_t>(1, load_solutions(path).size());
+
+				save_solutions(path, all_solutions_t(), is_binary);
+				Assert::AreEqual<size_t>(0, load_solutions(path).size());
+
+				std::filesystem::remove(path);
+			}
+		}
+
+		TEST_METHOD(binary_solutions_position_out_of_range)
+		{
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(32, 0));
+
+			all_solutions_t solutions;
+			solutions.insert(sol);
+
+			std::ostringstream stream;
+			Assert::ExpectException<std::runtime_error>([&]() { write_binary_solutions(stream, solutions); });
+		}
+
+		TEST_METHOD(binary_solutions_too_many_tiles)
+		{
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(0, 0));
+			all_solutions_t solutions;
+			solutions.insert(sol);
+
+			std::ostringstream stream;
+			write_binary_solutions(stream, solutions);
+
+			// A header claiming more tiles than a solution holds, followed by matching records.
+			std::string data = stream.str();
+			const std::string record = data.substr(sizeof(binary_solutions_header_t));
+			data[6] = char(200);
+			data[7] = 0;
+			for (int i = 1; i < 200; ++i)
+				data += record;
+
+			const std::filesystem::path path = std::filesystem::temp_directory_path() / "binary_solutions_tests.too_many.solutions.bin";
+			std::ofstream(path, std::ios::binary) << data;
+			Assert::ExpectException<std::runtime_error>([&]() { mapped_solutions_t mapped(path); });
+			Assert::ExpectException<std::runtime_error>([&]() { load_solutions(path); });
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(binary_solutions_invalid_tile)
+		{
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(0, 0));
+			all_solutions_t solutions;
+			solutions.insert(sol);
+
+			std::ostringstream stream;
+			write_binary_solutions(stream, solutions);
+			const std::string data = stream.str();
+			const size_t record_offset = sizeof(binary_solutions_header_t);
+
+			// Tile number 0, tile number 63 and rotation 7.
+			std::string invalid_records[3] = { data, data, data };
+			invalid_records[0][record_offset] = char(invalid_records[0][record_offset] & ~0x3F);
+			invalid_records[1][record_offset] = char(invalid_records[1][record_offset] | 0x3F);
+			invalid_records[2][record_offset] = char(invalid_records[2][record_offset] | 0xC0);
+			invalid_records[2][record_offset + 1] = char(invalid_records[2][record_offset + 1] | 0x01);
+
+			const std::filesystem::path path = std::filesystem::temp_directory_path() / "binary_solutions_tests.invalid_tile.solutions.bin";
+			for (const std::string& invalid : invalid_records)
+			{
+				std::ofstream(path, std::ios::binary) << invalid;
+				mapped_solutions_t mapped(path);
+				Assert::ExpectException<std::runtime_error>([&]() { mapped.solution(0); });
+			}
+			std::filesystem::remove(path);
+		}
+	};
+}
@@ -0,0 +1,80 @@
+#include "dak/tantrix/discovery.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/tantrix_tests/helpers.h"
+
+#include "CppUnitTest.h"
+
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::tantrix;
+
+namespace dak::tantrix::tests
+{
+	TEST_CLASS(discovery_tests)
+	{
+	public:
+
+		TEST_METHOD(discovery_puzzles_colors)
+		{
+			// Tiles 1 to 14 lack green, 15 to 23 blue and 24 to 30 yellow.
+			const std::vector<discovery_puzzle_t> puzzles = discovery_puzzles(3, 30);
+			Assert::AreEqual<size_t>(12 * 3 + 9 * 2 + 7, puzzles.size());
+			Assert::IsTrue(discovery_puzzle_t{ 3, color_t::red() } == puzzles[0]);
+			Assert::IsTrue(discovery_puzzle_t{ 3, color_t::blue() } == puzzles[1]);
+			Assert::IsTrue(discovery_puzzle_t{ 3, color_t::yellow() } == puzzles[2]);
+			Assert::IsTrue(discovery_puzzle_t{ 15, color_t::red() } == puzzles[36]);
+			Assert::IsTrue(discovery_puzzle_t{ 15, color_t::yellow() } == puzzles[37]);
+			Assert::IsTrue(discovery_puzzle_t{ 30, color_t::red() } == puzzles.back());
+
+			// Solutions have at most 32 tiles.
+			Assert::IsTrue(discovery_puzzle_t{ 32, color_t::red() } == discovery_puzzles(31, 56).back());
+		}
+
+		TEST_METHOD(solve_discovery_puzzles)
+		{
+			struct dummy_progress_t : dak::search::search_progress_t
+			{
+				void update_progress(size_t a_total_count_so_far) override {}
+			};
+
+			std::vector<size_t> solutions_counts;
+			for (const discovery_puzzle_t& discovery : discovery_puzzles(3, 5))
+			{
+				const auto puzzle = create_discovery_puzzle(discovery);
+				Assert::AreEqual<size_t>(discovery.tiles_count, puzzle->initial_tiles().size());
+
+				dummy_progress_t progress;
+				solutions_counts.push_back(dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(*puzzle, solution_t(*puzzle), progress).size());
+			}
+
+			// A yellow loop of three tiles, then red loops of four and five tiles.
+			Assert::IsTrue(std::vector<size_t>{ 0, 0, 1, 1, 0, 0, 1, 0, 0 } == solutions_counts);
+		}
+
+		TEST_METHOD(discovery_results_round_trip)
+		{
+			std::stringstream stream;
+			write_discovery_header(stream);
+			write_discovery_result(stream, discovery_result_t{ { 11, color_t::blue() }, "timeout", 0, 46100021, 20.5 });
+			write_discovery_result(stream, discovery_result_t{ { 10, color_t::yellow() }, "solved", 12, 4113560, 1.25 });
+			write_discovery_result(stream, discovery_result_t{ { 11, color_t::blue() }, "solved", 7, 98765432, 45.5 });
+			stream << "not,a,result\n";
+
+			const discovery_results_t results = read_discovery_results(stream);
+			Assert::AreEqual<size_t>(2, results.size());
+
+			const discovery_result_t& yellow = results.at(discovery_puzzle_t{ 10, color_t::yellow() });
+			Assert::AreEqual(std::string("solved"), yellow.status);
+			Assert::AreEqual<size_t>(12, yellow.solutions_count);
+			Assert::AreEqual<uint64_t>(4113560, yellow.nodes_count);
+			Assert::AreEqual(1.25, yellow.seconds);
+
+			// The later result of a puzzle replaces the earlier one.
+			const discovery_result_t& blue = results.at(discovery_puzzle_t{ 11, color_t::blue() });
+			Assert::AreEqual(std::string("solved"), blue.status);
+			Assert::AreEqual<size_t>(7, blue.solutions_count);
+		}
+	};
+}
@@ -0,0 +1,71 @@
+#include "dak/tantrix/multi_query.h"
+#include "dak/tantrix/tantrix.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/tantrix_tests/helpers.h"
+
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::tantrix;
+
+namespace dak::tantrix::tests
+{
+	TEST_CLASS(multi_query_tests)
+	{
+	public:
+
+		TEST_METHOD(group_queries_by_holes)
+		{
+			const std::vector<tile_t> tiles = { 3, 5, 8, 12, 14, 43, 46, 50, 52, 54, };
+			const std::vector<tile_t> reordered_tiles = { 54, 52, 50, 46, 43, 14, 12, 8, 5, 3, };
+
+			const std::vector<std::shared_ptr<puzzle_t>> puzzles =
+			{
+				std::make_shared<any_shape_puzzle_t>(tiles, std::vector<color_t>{ color_t::blue() }, true),
+				std::make_shared<any_shape_puzzle_t>(tiles, std::vector<color_t>{ color_t::red() }, true),
+				std::make_shared<any_shape_puzzle_t>(reordered_tiles, std::vector<color_t>{ color_t::blue() }, true, 0),
+				std::make_shared<triangle_puzzle_t>(tiles, std::vector<color_t>{ color_t::blue() }, true, 1),
+				std::make_shared<any_shape_puzzle_t>(tiles, std::vector<color_t>{ color_t::blue() }, true, 1),
+			};
+
+			const std::vector<query_group_t> groups = group_queries(puzzles);
+			Assert::AreEqual<size_t>(3, groups.size());
+			Assert::IsTrue(std::vector<size_t>{ 0, 2, 4 } == groups[0].query_indices);
+			Assert::IsTrue(std::vector<size_t>{ 1 } == groups[1].query_indices);
+			Assert::IsTrue(std::vector<size_t>{ 3 } == groups[2].query_indices);
+			Assert::IsFalse(groups[0].shared_puzzle->holes_count().has_value());
+			Assert::IsFalse(groups[2].shared_puzzle->holes_count().has_value());
+		}
+
+		TEST_METHOD(split_junior_solutions_by_holes)
+		{
+			const std::vector<tile_t> junior_tiles = { 3, 5, 8, 12, 14, 43, 46, 50, 52, 54, };
+			const std::vector<color_t> junior_loops = { color_t::blue(), };
+
+			const std::vector<std::shared_ptr<puzzle_t>> puzzles =
+			{
+				std::make_shared<any_shape_puzzle_t>(junior_tiles, junior_loops, true, 0),
+				std::make_shared<any_shape_puzzle_t>(junior_tiles, junior_loops, true, 1),
+				std::make_shared<any_shape_puzzle_t>(junior_tiles, junior_loops, true),
+			};
+
+			const std::vector<query_group_t> groups = group_queries(puzzles);
+			Assert::AreEqual<size_t>(1, groups.size());
+
+			struct dummy_progress_t : dak::search::search_progress_t
+			{
+				void update_progress(size_t a_total_count_so_far) override {}
+			};
+			dummy_progress_t progress;
+			const auto& shared_puzzle = dynamic_cast<const any_shape_puzzle_t&>(*groups[0].shared_puzzle);
+			const auto shared_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(shared_puzzle, solution_t(shared_puzzle), progress);
+
+			const std::vector<all_solutions_t> solutions = split_solutions(groups[0], puzzles, shared_solutions);
+			Assert::AreEqual<size_t>(3, solutions.size());
+			Assert::AreEqual<size_t>(3, solutions[0].size());
+			Assert::AreEqual<size_t>(0, solutions[1].size());
+			Assert::AreEqual<size_t>(3, solutions[2].size());
+		}
+	};
+}
@@ -0,0 +1,203 @@
+#include "dak/tantrix/parse.h"
+#include "dak/tantrix/format.h"
+#include "dak/tantrix/mask_puzzle.h"
+#include "dak/tantrix/stream.h"
+#include "dak/tantrix/triangle_puzzle.h"
+#include "dak/tantrix_tests/helpers.h"
+
+#include "CppUnitTest.h"
+
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::tantrix;
+
+namespace dak::tantrix::tests
+{
+	TEST_CLASS(parse_tests)
+	{
+	public:
+
+		TEST_METHOD(parse_tile_with_rotation)
+		{
+			const tile_t tile = tile_t(12).rotate(2);
+
+			std::ostringstream stream;
+			stream << tile;
+
+			Assert::AreEqual(tile, parse_tile(stream.str()));
+		}
+
+		TEST_METHOD(parse_triangle_puzzle)
+		{
+			auto puzzle = parse_puzzle("tiles: 1 2 3\r\nlines: R B\r\nshape: triangle\r\nholes: 2\r\n");
+
+			Assert::IsTrue(std::dynamic_pointer_cast<triangle_puzzle_t>(puzzle) != nullptr);
+			Assert::AreEqual<size_t>(3, puzzle->initial_tiles().size());
+			Assert::AreEqual<size_t>(2, puzzle->line_colors().size());
+			Assert::AreEqual(color_t::blue(), puzzle->line_colors()[1]);
+			Assert::IsFalse(puzzle->must_be_loops());
+			Assert::AreEqual<size_t>(2, puzzle->holes_count().value());
+		}
+
+		TEST_METHOD(parse_mask_puzzle)
+		{
+			auto puzzle = parse_puzzle("tiles: 1 2 3 4 5 6 7\nlines: R\nshape: mask\nmask:\n.XX\nXXX\nXX.\n");
+
+			auto mask_puzzle = std::dynamic_pointer_cast<mask_puzzle_t>(puzzle);
+			Assert::IsTrue(mask_puzzle != nullptr);
+			Assert::AreEqual<size_t>(3, mask_puzzle->mask().size());
+			Assert::AreEqual<std::string>("XX.", mask_puzzle->mask()[2]);
+
+			// The cells are filled from the first one with the fewest neighbours.
+			Assert::AreEqual<size_t>(7, mask_puzzle->slot_positions().size());
+			Assert::AreEqual(position_t(1, 0), mask_puzzle->slot_positions().front());
+
+			std::ostringstream stream;
+			stream << puzzle;
+			auto reparsed = std::dynamic_pointer_cast<mask_puzzle_t>(parse_puzzle(stream.str()));
+			Assert::IsTrue(reparsed != nullptr);
+			Assert::IsTrue(mask_puzzle->mask() == reparsed->mask());
+		}
+
+		TEST_METHOD(parse_mask_puzzle_errors)
+		{
+			try
+			{
+				parse_puzzle("tiles: 1 2 3\nlines: R\nshape: mask\nmask: XX\n");
+				Assert::Fail();
+			}
+			catch (const parse_error_t& ex)
+			{
+				Assert::AreEqual<size_t>(4, ex.line());
+				Assert::AreEqual<size_t>(1, ex.column());
+			}
+
+			try
+			{
+				parse_puzzle("tiles: 1 2 3\nlines: R\nshape: mask\nmask: XX\n.O\n");
+				Assert::Fail();
+			}
+			catch (const parse_error_t& ex)
+			{
+				Assert::AreEqual<size_t>(5, ex.line());
+				Assert::AreEqual<size_t>(1, ex.column());
+			}
+		}
+
+		TEST_METHOD(parse_puzzle_error_position)
+		{
+			try
+			{
+				parse_puzzle("tiles: 1 2 3\nloops: R X\n");
+				Assert::Fail();
+			}
+			catch (const parse_error_t& ex)
+			{
+				Assert::AreEqual<size_t>(2, ex.line());
+				Assert::AreEqual<size_t>(10, ex.column());
+			}
+
+			try
+			{
+				parse_puzzle("tiles: 1 57\n");
+				Assert::Fail();
+			}
+			catch (const parse_error_t& ex)
+			{
+				Assert::AreEqual<size_t>(1, ex.line());
+				Assert::AreEqual<size_t>(10, ex.column());
+			}
+		}
+
+		TEST_METHOD(parse_too_many_tiles)
+		{
+			// A solution holds at most 32 tiles.
+			std::string puzzle_text = "tiles:";
+			for (int number = 1; number <= 33; ++number)
+				puzzle_text += " " + std::to_string(number);
+
+			try
+			{
+				parse_puzzle(puzzle_text);
+				Assert::Fail();
+			}
+			catch (const parse_error_t& ex)
+			{
+				Assert::AreEqual<size_t>(1, ex.line());
+				Assert::AreEqual<size_t>(95, ex.column());
+			}
+
+			std::string solution_text = "valid\n";
+			for (int x = 0; x < 200; ++x)
+				solution_text += std::to_string(x) + "/0: 7 BBYRYR\n";
+
+			try
+			{
+				parse_solution(solution_text);
+				Assert::Fail();
+			}
+			catch (const parse_error_t& ex)
+			{
+				Assert::AreEqual<size_t>(34, ex.line());
+				Assert::AreEqual<size_t>(1, ex.column());
+			}
+		}
+
+		TEST_METHOD(parse_solutions_round_trip)
+		{
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(0, 0));
+			sol.add_tile(tile_t(8).rotate(2), position_t(1, 0));
+
+			solution_t other({});
+			other.add_tile(tile_t(9).rotate(5), position_t(-1, 2));
+
+			all_solutions_t solutions;
+			solutions.insert(sol);
+			solutions.insert(other);
+
+			std::ostringstream stream;
+			stream << solutions;
+
+			Assert::IsTrue(solutions == parse_solutions(stream.str()));
+		}
+
+		TEST_METHOD(write_solution_text)
+		{
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(0, 0));
+			sol.add_tile(tile_t(8).rotate(2), position_t(1, -1));
+
+			dak::search::text_writer_t writer;
+			write_solution(writer, sol);
+
+			Assert::AreEqual(std::string("valid\n0/0: 7 BBYRYR\n1/-1: 8 RYBBRY\n"), writer.text());
+			Assert::IsTrue(sol == parse_solution(writer.text()));
+		}
+
+		TEST_METHOD(parse_solution_error_position)
+		{
+			try
+			{
+				parse_solution("valid\n0/0: 7 RRGGBY\n1/0 8 YYBBRR\n");
+				Assert::Fail();
+			}
+			catch (const parse_error_t& ex)
+			{
+				Assert::AreEqual<size_t>(2, ex.line());
+				Assert::AreEqual<size_t>(8, ex.column());
+			}
+		}
+
+		TEST_METHOD(stream_fails_on_parse_error)
+		{
+			std::istringstream stream("tiles: 1 two 3\n");
+			std::shared_ptr<puzzle_t> puzzle;
+			stream >> puzzle;
+
+			Assert::IsTrue(stream.fail());
+			Assert::IsTrue(puzzle == nullptr);
+		}
+	};
+}
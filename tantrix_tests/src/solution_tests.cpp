@@ -192,6 +192,21 @@ namespace dak::tantrix::tests
 			}
 		}
 
+      TEST_METHOD(solution_longest_line_length)
+      {
+         solution_t sol({});
+         Assert::AreEqual<size_t>(0, sol.longest_line_length(color_t::red()));
+
+         sol.add_tile(tile_t(1), position_t(0, 0));
+         sol.add_tile(tile_t(4), position_t(1, 0));
+         sol.add_tile(tile_t(13), position_t(1, 1));
+
+         Assert::AreEqual<size_t>(3, sol.longest_line_length(color_t::red()));
+         Assert::AreEqual<size_t>(1, sol.longest_line_length(color_t::blue()));
+         Assert::AreEqual<size_t>(1, sol.longest_line_length(color_t::yellow()));
+         Assert::AreEqual<size_t>(0, sol.longest_line_length(color_t::green()));
+      }
+
       TEST_METHOD(solution_count_neighbours)
       {
          solution_t sol({});
@@ -228,5 +243,84 @@ namespace dak::tantrix::tests
          sol.add_tile(tile_t(21), position_t(-1, 1));
          Assert::AreEqual<size_t>(1, sol.count_holes());
       }
+
+      TEST_METHOD(solution_placement_hash)
+      {
+         solution_t sol({});
+         sol.add_tile(tile_t(7), position_t(0, 0));
+         sol.add_tile(tile_t(8), position_t(1, 0));
+         sol.add_tile(tile_t(9), position_t(1, 1));
+
+         solution_t other_order({});
+         other_order.add_tile(tile_t(9), position_t(1, 1));
+         other_order.add_tile(tile_t(7), position_t(0, 0));
+         other_order.add_tile(tile_t(8), position_t(1, 0));
+
+         Assert::AreEqual(sol.placement_hash(), other_order.placement_hash());
+
+         solution_t rotated({});
+         rotated.add_tile(tile_t(7), position_t(0, 0));
+         rotated.add_tile(tile_t(8).rotate(1), position_t(1, 0));
+         rotated.add_tile(tile_t(9), position_t(1, 1));
+
+         Assert::AreNotEqual(sol.placement_hash(), rotated.placement_hash());
+
+         solution_t moved({});
+         moved.add_tile(tile_t(7), position_t(0, 0));
+         moved.add_tile(tile_t(8), position_t(1, 1));
+         moved.add_tile(tile_t(9), position_t(1, 0));
+
+         Assert::AreNotEqual(sol.placement_hash(), moved.placement_hash());
+      }
+
+      TEST_METHOD(solution_hash)
+      {
+         solution_t sol({});
+         sol.add_tile(tile_t(7), position_t(0, 0));
+         sol.add_tile(tile_t(8), position_t(1, 0));
+
+         solution_t same({});
+         same.add_tile(tile_t(7), position_t(0, 0));
+         same.add_tile(tile_t(8), position_t(1, 0));
+
+         Assert::IsTrue(sol == same);
+         Assert::AreEqual(sol.hash(), same.hash());
+
+         solution_t moved({});
+         moved.add_tile(tile_t(7), position_t(0, 0));
+         moved.add_tile(tile_t(8), position_t(1, 1));
+
+         Assert::AreNotEqual(sol.hash(), moved.hash());
+      }
+
+      TEST_METHOD(solution_compatible_rotations)
+      {
+         solution_t sol({});
+         Assert::AreEqual(0x3Fu, sol.compatible_rotations(tile_t(4), position_t(0, 0)));
+
+         sol.add_tile(tile_t(1), position_t(0, 0));
+         sol.add_tile(tile_t(4).rotate(2), position_t(1, 0));
+         sol.add_tile(tile_t(9).rotate(1), position_t(0, 1));
+         Assert::AreEqual(0u, sol.compatible_rotations(tile_t(4), position_t(0, 0)));
+
+         // The mask must agree with checking each rotation on its own,
+         // whatever the rotation of the tile to place.
+         for (int number = 1; number < 57; ++number)
+         {
+            for (int x = -2; x <= 2; ++x)
+            {
+               for (int y = -2; y <= 2; ++y)
+               {
+                  const tile_t tile = tile_t(number).rotate(number % 6);
+                  const unsigned rotations = sol.compatible_rotations(tile, position_t(x, y));
+                  for (int rotation = 0; rotation < 6; ++rotation)
+                  {
+                     const bool is_compatible = sol.is_compatible(solution_t::part_t(tile.rotate(rotation), position_t(x, y)));
+                     Assert::AreEqual(is_compatible, (rotations & (1u << rotation)) != 0);
+                  }
+               }
+            }
+         }
+      }
 };
 }
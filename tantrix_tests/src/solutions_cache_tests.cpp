@@ -0,0 +1,74 @@
+#include "dak/tantrix/solutions_cache.h"
+#include "dak/tantrix_tests/helpers.h"
+
+#include "CppUnitTest.h"
+
+#include <filesystem>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::tantrix;
+
+namespace dak::tantrix::tests
+{
+	TEST_CLASS(solutions_cache_tests)
+	{
+	public:
+
+		TEST_METHOD(canonical_hash_ignores_order)
+		{
+			const triangle_puzzle_t puzzle({ tile_t(3), tile_t(1), tile_t(2) }, { color_t::red(), color_t::blue() }, true);
+			const triangle_puzzle_t reordered({ tile_t(2), tile_t(3), tile_t(1) }, { color_t::blue(), color_t::red() }, true);
+
+			Assert::AreEqual(canonical_puzzle_description(puzzle), canonical_puzzle_description(reordered));
+			Assert::AreEqual(canonical_puzzle_hash(puzzle), canonical_puzzle_hash(reordered));
+		}
+
+		TEST_METHOD(canonical_hash_differs)
+		{
+			const triangle_puzzle_t puzzle({ tile_t(1), tile_t(2), tile_t(3) }, { color_t::red() }, true);
+			const triangle_puzzle_t lines({ tile_t(1), tile_t(2), tile_t(3) }, { color_t::red() }, false);
+			const any_shape_puzzle_t any_shape({ tile_t(1), tile_t(2), tile_t(3) }, { color_t::red() }, true);
+			const triangle_puzzle_t holes({ tile_t(1), tile_t(2), tile_t(3) }, { color_t::red() }, true, 0);
+
+			const auto hash = canonical_puzzle_hash(puzzle);
+			Assert::AreNotEqual(hash, canonical_puzzle_hash(lines));
+			Assert::AreNotEqual(hash, canonical_puzzle_hash(any_shape));
+			Assert::AreNotEqual(hash, canonical_puzzle_hash(holes));
+			Assert::AreNotEqual(hash, canonical_puzzle_hash(puzzle, solver_version + 1));
+		}
+
+		TEST_METHOD(solutions_cache_round_trip)
+		{
+			const std::filesystem::path directory = std::filesystem::temp_directory_path() / "solutions_cache_tests";
+			std::filesystem::remove_all(directory);
+
+			const triangle_puzzle_t puzzle({ tile_t(7), tile_t(8) }, { color_t::red() }, false);
+
+			solution_t sol({});
+			sol.add_tile(tile_t(7), position_t(0, 0));
+			sol.add_tile(tile_t(8).rotate(2), position_t(1, 0));
+
+			all_solutions_t solutions;
+			solutions.insert(sol);
+
+			{
+				solutions_cache_t cache(directory, 1);
+				Assert::IsFalse(cache.find(puzzle).has_value());
+				Assert::IsTrue(cache.store(puzzle, solutions));
+
+				const auto cached = cache.find(puzzle);
+				Assert::IsTrue(cached.has_value());
+				Assert::IsTrue(solutions == *cached);
+			}
+
+			// Another version of the solver does not see, and removes, the cached solutions.
+			{
+				solutions_cache_t cache(directory, 2);
+				Assert::IsFalse(cache.find(puzzle).has_value());
+				Assert::IsFalse(std::filesystem::exists(directory / "solver-1"));
+			}
+
+			std::filesystem::remove_all(directory);
+		}
+	};
+}
@@ -1,10 +1,16 @@
 #include "dak/tantrix/tantrix.h"
 #include "dak/solver/solve.h"
+#include "dak/search/estimate.h"
+#include "dak/search/progress.h"
+#include "dak/search/solve.h"
+#include "dak/search/trace.h"
 #include "dak/utility/progress.h"
 #include "dak/tantrix_tests/helpers.h"
 
 #include "CppUnitTest.h"
 
+#include <sstream>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace dak::tantrix;
 using namespace dak::utility;
@@ -50,5 +56,321 @@ namespace dak::tantrix::tests
 
          Assert::AreEqual<size_t>(1, professor_solutions.size());
       }
+
+      TEST_METHOD(solve_junior_puzzle_statistics)
+      {
+         const std::vector<tile_t> junior_tiles = { 3, 5, 8, 12, 14, 43, 46, 50, 52, 54, };
+         const std::vector<color_t> junior_loops = { color_t::blue(), };
+         auto junior_puzzle = any_shape_puzzle_t(junior_tiles, junior_loops, true);
+
+         struct dummy_progress_t : dak::search::search_progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+         dummy_progress_t progress;
+         auto junior_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(junior_puzzle, solution_t(junior_puzzle), progress);
+
+         Assert::AreEqual<size_t>(3, junior_solutions.size());
+         Assert::AreEqual<size_t>(10, progress.counters().depth_histogram().size());
+
+         std::ostringstream stream;
+         dak::search::write_json(stream, progress.counters());
+         Assert::IsTrue(stream.str().find("\"nodes\": " + std::to_string(progress.counters().nodes_count()) + ",") != std::string::npos);
+         Assert::IsTrue(stream.str().find("\"nodes_per_depth\": [1, ") != std::string::npos);
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+         // The same solutions are found more than once, so only the leaves give a bound.
+         const uint64_t invalid_count = progress.counters().rule_counts().total(dak::search::rule_counts_t::invalid_solution);
+         Assert::IsTrue(invalid_count > 0 && invalid_count < progress.counters().depth_histogram().back());
+#endif
+      }
+
+      TEST_METHOD(solve_puzzles_with_solutions_limit)
+      {
+         struct dummy_progress_t : dak::search::search_progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+
+         const std::vector<tile_t> junior_tiles = { 3, 5, 8, 12, 14, 43, 46, 50, 52, 54, };
+         auto junior_puzzle = any_shape_puzzle_t(junior_tiles, { color_t::blue(), }, true);
+         dummy_progress_t junior_progress;
+         junior_progress.set_solutions_limit(2);
+         auto junior_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(junior_puzzle, solution_t(junior_puzzle), junior_progress);
+
+         // The threads stop soon after the limit, so a few more solutions can be found.
+         Assert::IsTrue(junior_solutions.size() >= 2);
+
+         const std::vector<tile_t> professor_tiles = { 2, 11, 15, 17, 20, 30, 38, 39, 44, 45, 51, 56, };
+         auto professor_puzzle = any_shape_puzzle_t(professor_tiles, { color_t::blue(), color_t::yellow(), }, true);
+         dummy_progress_t professor_progress;
+         professor_progress.set_solutions_limit(2);
+         auto professor_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(professor_puzzle, solution_t(professor_puzzle), professor_progress);
+
+         Assert::AreEqual<size_t>(1, professor_solutions.size());
+      }
+
+      TEST_METHOD(solve_puzzle_twice_with_transposition_table)
+      {
+         struct dummy_progress_t : dak::search::search_progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+
+         // The partial solutions recorded by a search or by an estimate must not prune the next search.
+         const std::vector<tile_t> student_tiles = { 19, 21, 24, 25, 29, 31, 32, 40, 41, 42, };
+         auto student_puzzle = any_shape_puzzle_t(student_tiles, { color_t::green(), }, true);
+         student_puzzle.use_transposition_table(1024 * 1024);
+
+         dummy_progress_t first_progress;
+         auto first_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(student_puzzle, solution_t(student_puzzle), first_progress);
+         Assert::AreEqual<size_t>(6, first_solutions.size());
+
+         dummy_progress_t second_progress;
+         auto second_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(student_puzzle, solution_t(student_puzzle), second_progress);
+         Assert::IsTrue(first_solutions == second_solutions);
+
+         dak::search::estimator_t<any_shape_puzzle_t, solution_t>::estimate(student_puzzle, solution_t(student_puzzle), 100);
+         dummy_progress_t third_progress;
+         auto third_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(student_puzzle, solution_t(student_puzzle), third_progress);
+         Assert::IsTrue(first_solutions == third_solutions);
+         Assert::IsTrue(student_puzzle.transposition_table()->lookups_count() > 0);
+      }
+
+      TEST_METHOD(solve_puzzle_with_best_partial)
+      {
+         struct dummy_progress_t : dak::search::search_progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+
+         // The three tiles make a red line, but not a red loop, so the full
+         // boards are not valid and the best partial solution has two tiles.
+         for (const std::vector<tile_t>& tiles : { std::vector<tile_t>{ 1, 2, 3, }, std::vector<tile_t>{ 5, 6, 7, } })
+         {
+            auto puzzle = any_shape_puzzle_t(tiles, { color_t::red(), }, true);
+            dak::search::best_partial_t<solution_t> best_partial;
+            dummy_progress_t progress;
+            progress.set_best_partial(&best_partial);
+            auto solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(puzzle, solution_t(puzzle), progress);
+
+            Assert::AreEqual<size_t>(0, solutions.size());
+            Assert::IsTrue(best_partial.solution().has_value());
+            Assert::AreEqual<size_t>(2, best_partial.solution()->tiles_count());
+         }
+
+         // A valid full board is the best partial solution of a solvable puzzle.
+         const std::vector<tile_t> junior_tiles = { 3, 5, 8, 12, 14, 43, 46, 50, 52, 54, };
+         auto junior_puzzle = any_shape_puzzle_t(junior_tiles, { color_t::blue(), }, true);
+         dak::search::best_partial_t<solution_t> best_partial;
+         dummy_progress_t progress;
+         progress.set_best_partial(&best_partial);
+         auto junior_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(junior_puzzle, solution_t(junior_puzzle), progress);
+
+         Assert::AreEqual<size_t>(junior_tiles.size(), best_partial.solution()->tiles_count());
+         Assert::IsTrue(junior_puzzle.is_solution_valid(*best_partial.solution()));
+         Assert::AreEqual<int64_t>(int64_t(junior_tiles.size()), best_partial.rank().score);
+      }
+
+      TEST_METHOD(solve_stopped_puzzle_with_best_partial)
+      {
+         struct stopping_progress_t : dak::search::search_progress_t
+         {
+            stopping_progress_t() : search_progress_t(1) {}
+            void update_progress(size_t a_total_count_so_far) override { throw std::runtime_error("stop"); }
+         };
+
+         const std::vector<tile_t> junior_tiles = { 3, 5, 8, 12, 14, 43, 46, 50, 52, 54, };
+         auto junior_puzzle = any_shape_puzzle_t(junior_tiles, { color_t::blue(), }, true);
+         dak::search::best_partial_t<solution_t> best_partial;
+         stopping_progress_t progress;
+         progress.set_best_partial(&best_partial);
+         Assert::ExpectException<std::runtime_error>([&]()
+         {
+            dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(junior_puzzle, solution_t(junior_puzzle), progress);
+         });
+
+         // The partial solutions seen before the stop are kept.
+         Assert::IsTrue(best_partial.solution().has_value());
+         Assert::IsTrue(best_partial.solution()->tiles_count() > 1);
+      }
+
+      TEST_METHOD(solve_extreme_blue_triangle_puzzle)
+      {
+         const std::vector<tile_t> extreme_tiles = { 38, 30, 42, 26, 40, 27, 12, 6, 7, 25, };
+         const std::vector<color_t> extreme_lines = { color_t::blue(), };
+         auto extreme_puzzle = triangle_puzzle_t(extreme_tiles, extreme_lines, false);
+
+         struct dummy_progress_t : progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+         dummy_progress_t progress;
+         auto extreme_solutions = dak::search::solver_t<triangle_puzzle_t, solution_t>::solve(extreme_puzzle, solution_t(extreme_puzzle), progress);
+
+         Assert::AreEqual<size_t>(9, extreme_solutions.size());
+
+         // The solver trusts the triangle puzzle to only give compatible parts.
+         for (const solution_t& solution : extreme_solutions)
+         {
+            solution_t rebuilt(extreme_puzzle);
+            for (size_t i = 0; i < solution.tiles_count(); ++i)
+            {
+               Assert::IsTrue(rebuilt.is_compatible(solution.tiles()[i]));
+               rebuilt.add_part(solution.tiles()[i]);
+            }
+         }
+      }
+
+      TEST_METHOD(solve_extreme_blue_triangle_puzzle_fill_orders)
+      {
+         const std::vector<tile_t> extreme_tiles = { 38, 30, 42, 26, 40, 27, 12, 6, 7, 25, };
+         const std::vector<color_t> extreme_lines = { color_t::blue(), };
+
+         struct dummy_progress_t : progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+
+         for (const auto order : { triangle_puzzle_t::fill_order_t::rows, triangle_puzzle_t::fill_order_t::spiral,
+                                   triangle_puzzle_t::fill_order_t::edge_first, triangle_puzzle_t::fill_order_t::automatic })
+         {
+            auto extreme_puzzle = triangle_puzzle_t(extreme_tiles, extreme_lines, false, {}, order);
+            Assert::IsTrue(extreme_puzzle.fill_order() != triangle_puzzle_t::fill_order_t::automatic);
+
+            dummy_progress_t progress;
+            auto extreme_solutions = dak::search::solver_t<triangle_puzzle_t, solution_t>::solve(extreme_puzzle, solution_t(extreme_puzzle), progress);
+
+            Assert::AreEqual<size_t>(9, extreme_solutions.size());
+         }
+      }
+
+      TEST_METHOD(solve_extreme_blue_mask_puzzle)
+      {
+         // The triangle of the extreme puzzle, given as a mask.
+         const std::vector<tile_t> extreme_tiles = { 38, 30, 42, 26, 40, 27, 12, 6, 7, 25, };
+         const std::vector<color_t> extreme_lines = { color_t::blue(), };
+         auto extreme_puzzle = mask_puzzle_t(extreme_tiles, extreme_lines, false, { "...X", "..XX", ".XXX", "XXXX" });
+
+         struct dummy_progress_t : progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+         dummy_progress_t progress;
+         auto extreme_solutions = dak::search::solver_t<mask_puzzle_t, solution_t>::solve(extreme_puzzle, solution_t(extreme_puzzle), progress);
+
+         Assert::AreEqual<size_t>(9, extreme_solutions.size());
+      }
+
+      TEST_METHOD(solve_single_loop_triangle_and_mask_puzzles)
+      {
+         // The triangle places the first tile of a single loop in a fixed rotation,
+         // so it must find the same solutions as the same triangle given as a mask.
+         struct dummy_progress_t : dak::search::search_progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+
+         size_t solved_count = 0;
+         for (const color_t color : { color_t::red(), color_t::blue(), color_t::yellow(), color_t::green() })
+         {
+            for (int first = 20; first <= 32; ++first)
+            {
+               for (int second = first + 1; second <= 32; ++second)
+               {
+                  for (int third = second + 1; third <= 32; ++third)
+                  {
+                     const std::vector<tile_t> tiles = { first, second, third, };
+                     if (!tiles[0].has_color(color) || !tiles[1].has_color(color) || !tiles[2].has_color(color))
+                        continue;
+
+                     auto triangle_puzzle = triangle_puzzle_t(tiles, { color, }, true);
+                     auto mask_puzzle = mask_puzzle_t(tiles, { color, }, true, { ".X", "XX" });
+
+                     dummy_progress_t triangle_progress;
+                     dummy_progress_t mask_progress;
+                     auto triangle_solutions = dak::search::solver_t<triangle_puzzle_t, solution_t>::solve(triangle_puzzle, solution_t(triangle_puzzle), triangle_progress);
+                     auto mask_solutions = dak::search::solver_t<mask_puzzle_t, solution_t>::solve(mask_puzzle, solution_t(mask_puzzle), mask_progress);
+
+                     Assert::AreEqual(mask_solutions.size(), triangle_solutions.size());
+                     solved_count += mask_solutions.size() > 0 ? 1 : 0;
+                  }
+               }
+            }
+         }
+
+         // Make sure some of them have solutions, like the red loop of the tiles 25, 26 and 27.
+         Assert::IsTrue(solved_count > 0);
+         auto puzzle = triangle_puzzle_t({ 25, 26, 27, }, { color_t::red(), }, true);
+         dummy_progress_t progress;
+         Assert::AreEqual<size_t>(1, dak::search::solver_t<triangle_puzzle_t, solution_t>::solve(puzzle, solution_t(puzzle), progress).size());
+      }
+
+      TEST_METHOD(solve_pyramid_triangle_puzzle)
+      {
+         const std::vector<tile_t> pyramid_tiles = { 21, 3, 15, 13, 5, 2, 35, 9, 18, 17, 33, 20, 10, 12, 8, };
+         const std::vector<color_t> pyramid_loops = { color_t::red(), };
+         auto pyramid_puzzle = triangle_puzzle_t(pyramid_tiles, pyramid_loops, true);
+
+         struct dummy_progress_t : dak::search::search_progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+         dummy_progress_t progress;
+         auto pyramid_solutions = dak::search::solver_t<triangle_puzzle_t, solution_t>::solve(pyramid_puzzle, solution_t(pyramid_puzzle), progress);
+
+         Assert::AreEqual<size_t>(1, pyramid_solutions.size());
+         Assert::IsTrue(pyramid_solutions.begin()->has_line(color_t::red(), true));
+
+         // Partial pyramids that cannot complete the loop are cut early.
+         Assert::IsTrue(progress.counters().nodes_count() < 1000000);
+#if defined(DAK_SEARCH_INSTRUMENTATION)
+         Assert::IsTrue(progress.counters().rule_counts().total(dak::search::rule_counts_t::line_bound) > 0);
+#endif
+      }
+
+      TEST_METHOD(solve_junior_puzzle_trace)
+      {
+         const std::vector<tile_t> junior_tiles = { 3, 5, 8, 12, 14, 43, 46, 50, 52, 54, };
+         const std::vector<color_t> junior_loops = { color_t::blue(), };
+         auto junior_puzzle = any_shape_puzzle_t(junior_tiles, junior_loops, true);
+
+         struct dummy_progress_t : dak::search::search_progress_t
+         {
+            void update_progress(size_t a_total_count_so_far) override {}
+         };
+         dummy_progress_t progress;
+         dak::search::trace_recorder_t trace;
+         progress.set_trace(&trace);
+         dak::search::thread_pool_t thread_pool(2);
+         auto junior_solutions = dak::search::solver_t<any_shape_puzzle_t, solution_t>::solve(junior_puzzle, solution_t(junior_puzzle), progress, thread_pool);
+
+         Assert::AreEqual<size_t>(3, junior_solutions.size());
+         Assert::AreEqual<size_t>(2, trace.threads_count());
+
+         const auto split_events = trace.events(dak::search::trace_recorder_t::caller_thread);
+         Assert::AreEqual<size_t>(1, split_events.size());
+         Assert::AreEqual(std::string("split"), std::string(split_events[0].name));
+
+         // Each work item is taken and searched once, by one of the threads.
+         size_t subtrees_count = 0;
+         size_t inserts_count = 0;
+         for (size_t thread = 0; thread < trace.threads_count(); ++thread)
+         {
+            for (const auto& event : trace.events(thread))
+            {
+               if (std::string(event.name) == "subtree")
+                  subtrees_count += 1;
+               if (std::string(event.name) == "insert_solution")
+                  inserts_count += 1;
+            }
+         }
+         Assert::AreEqual<size_t>(split_events[0].arg, subtrees_count);
+         Assert::IsTrue(inserts_count >= junior_solutions.size());
+
+         std::ostringstream stream;
+         trace.write_chrome_trace(stream);
+         Assert::IsTrue(stream.str().find("\"traceEvents\": [") != std::string::npos);
+         Assert::IsTrue(stream.str().find("\"name\": \"subtree\", \"ph\": \"X\"") != std::string::npos);
+      }
    };
 }